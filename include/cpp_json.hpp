@@ -14,7 +14,18 @@
  */
 
 #include "json/api.hpp"
+#include "json/async_loader.hpp"
+#include "json/async_parse.hpp"
 #include "json/builder.hpp"
+#include "json/canonical.hpp"
+#include "json/clone.hpp"
+#include "json/concurrent_arena.hpp"
+#include "json/document.hpp"
+#include "json/mapped_file.hpp"
+#include "json/parse_options.hpp"
+#include "json/stream_parser.hpp"
+#include "json/stream_writer.hpp"
+#include "json/validator.hpp"
 
 namespace json {
 
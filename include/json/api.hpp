@@ -16,10 +16,20 @@
 
 #include "ast.hpp"
 #include "arena.hpp"
+#include "concurrent_arena.hpp"
+#include "document.hpp"
 #include "error.hpp"
+#include "parse_options.hpp"
+#include "parser.hpp"
+#include "tokenizer.hpp"
+#include "sink.hpp"
+#include "writer.hpp"
+#include <iterator>
 #include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace json {
 
@@ -28,18 +38,163 @@ namespace json {
  * 
  * @param input The input buffer containing JSON data.
  * @param arena The memory arena used for allocating AST nodes.
+ * @param options Parse options, e.g. UTF-8 validation.
  * @return Result<Node*> The root node of the parsed AST, or an error.
  */
-Result<Node*> parse(std::span<const char> input, Arena& arena);
+Result<Node*> parse(std::span<const char> input, Arena& arena, const ParseOptions& options = {});
 
 /**
  * @brief Parses a JSON string from a string view.
  * 
  * @param input The input string containing JSON data.
  * @param arena The memory arena used for allocating AST nodes.
+ * @param options Parse options, e.g. UTF-8 validation.
  * @return Result<Node*> The root node of the parsed AST, or an error.
  */
-Result<Node*> parse(std::string_view input, Arena& arena);
+Result<Node*> parse(std::string_view input, Arena& arena, const ParseOptions& options = {});
+
+/**
+ * @brief Parses JSON with a tokenizer and parser specialized for `Policy`.
+ * 
+ * Each policy selects a separately compiled engine containing only the
+ * checks it names; pick one per call site. DefaultPolicy behaves like the
+ * non-template parse().
+ * 
+ * Example:
+ *   auto root = json::parse<json::TrustedPolicy>(internal_message, arena);
+ * 
+ * @tparam Policy DefaultPolicy, TrustedPolicy, StrictPolicy or TrustedIntegerPolicy.
+ * @param input The input buffer containing JSON data.
+ * @param arena The memory arena used for allocating AST nodes.
+ * @param options Parse options; ignored unless the policy reads options at runtime.
+ * @return Result<Node*> The root node of the parsed AST, or an error.
+ */
+template <typename Policy>
+Result<Node*> parse(std::span<const char> input, Arena& arena, const ParseOptions& options = {}) {
+    BasicTokenizer<Policy> tokenizer(input, arena, options);
+    BasicParser<Policy> parser(arena, tokenizer, options);
+    return parser.parse();
+}
+
+/**
+ * @brief Parses a string view with a parser specialized for `Policy`.
+ * 
+ * @tparam Policy DefaultPolicy, TrustedPolicy, StrictPolicy or TrustedIntegerPolicy.
+ * @param input The input string containing JSON data.
+ * @param arena The memory arena used for allocating AST nodes.
+ * @param options Parse options; ignored unless the policy reads options at runtime.
+ * @return Result<Node*> The root node of the parsed AST, or an error.
+ */
+template <typename Policy>
+Result<Node*> parse(std::string_view input, Arena& arena, const ParseOptions& options = {}) {
+    return parse<Policy>(std::span{input.data(), input.size()}, arena, options);
+}
+
+/**
+ * @brief Checks whether a buffer holds valid JSON without building a tree.
+ * 
+ * Applies the same checks as parse() and reports the same errors. It
+ * allocates nothing, except with DuplicateKeys::Reject, which keeps a copy
+ * of every key of the open objects (escaped keys are decoded first).
+ * 
+ * @param input The input buffer containing JSON data.
+ * @param options Parse options, e.g. UTF-8 validation.
+ * @return Result<void> Success, or the first error.
+ */
+Result<void> validate(std::span<const char> input, const ParseOptions& options = {});
+
+/**
+ * @brief Checks whether a string holds valid JSON without building a tree.
+ * 
+ * @param input The input string containing JSON data.
+ * @param options Parse options, e.g. UTF-8 validation.
+ * @return Result<void> Success, or the first error.
+ */
+Result<void> validate(std::string_view input, const ParseOptions& options = {});
+
+/**
+ * @brief Parses JSON into a self-contained Document.
+ * 
+ * The document owns a fresh arena, so the result can be moved freely and
+ * outlives any arena on the caller's side. String values that need no
+ * unescaping still reference `input`, which must outlive the document.
+ * 
+ * @param input The input buffer containing JSON data.
+ * @param block_size Block size of the document's arena.
+ * @param upstream Memory resource for the document's arena.
+ * @return Result<Document> The parsed document, or an error.
+ */
+Result<Document> parse_document(std::span<const char> input,
+                                size_t block_size = Arena::DefaultBlockSize,
+                                std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+/**
+ * @brief Parses JSON from a string view into a self-contained Document.
+ * 
+ * @param input The input string containing JSON data.
+ * @param block_size Block size of the document's arena.
+ * @param upstream Memory resource for the document's arena.
+ * @return Result<Document> The parsed document, or an error.
+ */
+Result<Document> parse_document(std::string_view input,
+                                size_t block_size = Arena::DefaultBlockSize,
+                                std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+/**
+ * @brief Parses a file into a Document that owns a mapping of it.
+ * 
+ * The file is memory-mapped rather than read into the arena: unescaped
+ * strings point straight into the mapping, so the file's bytes are never
+ * copied and occupy only page cache. The mapping is released with the
+ * document.
+ * 
+ * @param filename Path to the JSON file.
+ * @param block_size Block size of the document's arena.
+ * @param upstream Memory resource for the document's arena.
+ * @return Result<Document> The parsed document, or an error.
+ */
+Result<Document> parse_document_file(const char* filename,
+                                     size_t block_size = Arena::DefaultBlockSize,
+                                     std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+/**
+ * @brief Parses many small documents into one arena.
+ * 
+ * One tokenizer-parser pair and its scratch buffers are reused for the
+ * whole batch, and all trees share the arena's blocks, so the per-document
+ * cost is the parse itself. A failed document does not stop the batch.
+ * 
+ * Example:
+ *   Arena arena;
+ *   auto results = parse_batch(messages, arena);
+ *   for (auto& result : results) {
+ *       if (result) handle(*result);
+ *   }
+ * 
+ * @param inputs The documents to parse.
+ * @param arena The memory arena receiving every tree.
+ * @return std::vector<Result<Node*>> One root node or error per input, in order.
+ */
+std::vector<Result<Node*>> parse_batch(std::span<const std::span<const char>> inputs, Arena& arena);
+
+/**
+ * @brief Parses many small documents on several threads.
+ * 
+ * The inputs are split into contiguous ranges, one per thread. Each thread
+ * runs its own parser over an Arena that draws blocks from `arena`, so the
+ * trees stay valid until `arena` is destroyed.
+ * 
+ * @param inputs The documents to parse.
+ * @param arena The thread-safe arena backing every tree.
+ * @param threads Number of threads; 0 uses the hardware concurrency.
+ * @param block_size Block size of each thread's arena; keep it at most a
+ *                   quarter of the arena's chunk size, less alignment, so
+ *                   blocks come from the calling thread's chunk.
+ * @return std::vector<Result<Node*>> One root node or error per input, in order.
+ */
+std::vector<Result<Node*>> parse_batch(std::span<const std::span<const char>> inputs,
+                                       ConcurrentArena& arena, unsigned threads = 0,
+                                       size_t block_size = ConcurrentArena::DefaultLocalBlockSize);
 
 /**
  * @brief Serializes an AST into a JSON string.
@@ -50,9 +205,93 @@ Result<Node*> parse(std::string_view input, Arena& arena);
  */
 std::string write(const Node* root, bool pretty = false);
 
+/**
+ * @brief Serializes an AST into a sink (file, descriptor, callback, ...).
+ * 
+ * @param root The root node of the AST to serialize.
+ * @param sink The destination of the output; flushed when done.
+ * @param pretty If true, formats the output with indentation and newlines.
+ * @return true If all output reached the sink's destination.
+ */
+bool write(const Node* root, Sink& sink, bool pretty = false);
+
+/**
+ * @brief Serializes an AST into a caller-provided buffer.
+ * 
+ * Nothing is allocated. If the buffer is too small, it holds a prefix of
+ * the output and the result reports the size needed; json::measure() gives
+ * that size up front.
+ * 
+ * @param root The root node of the AST to serialize.
+ * @param out The buffer to write into.
+ * @param pretty If true, formats the output with indentation and newlines.
+ * @return WriteResult Bytes written and the size the full output needs.
+ */
+WriteResult write(const Node* root, std::span<char> out, bool pretty = false);
+
+/**
+ * @brief Serializes an AST into a character array; see the std::span overload.
+ * 
+ * Without it an array would decay to a pointer and bind to `pretty`.
+ * 
+ * @param root The root node of the AST to serialize.
+ * @param out The array to write into.
+ * @param pretty If true, formats the output with indentation and newlines.
+ * @return WriteResult Bytes written and the size the full output needs.
+ */
+template<size_t N>
+WriteResult write(const Node* root, char (&out)[N], bool pretty = false) {
+    return write(root, std::span<char>(out), pretty);
+}
+
+/// Raw pointers carry no bound (and would otherwise bind to `pretty`);
+/// pass a std::span<char> instead.
+template<typename Pointer>
+    requires std::is_same_v<std::remove_cvref_t<Pointer>, char*>
+WriteResult write(const Node* root, Pointer&& out, bool pretty = false) = delete;
+
+/**
+ * @brief Serializes an AST into memory allocated from an arena.
+ * 
+ * The output size is measured first, so exactly one arena allocation is
+ * made. The text is not null-terminated and lives as long as the arena.
+ * 
+ * @param root The root node of the AST to serialize.
+ * @param arena The arena providing the output memory.
+ * @param pretty If true, formats the output with indentation and newlines.
+ * @return Result<std::string_view> The JSON text, or ErrorCode::OutOfMemory
+ *         when the arena's budget is exhausted.
+ */
+Result<std::string_view> write(const Node* root, Arena& arena, bool pretty = false);
+
+/**
+ * @brief Serializes an AST through an output iterator.
+ * 
+ * Output is batched in a small buffer and copied to the iterator in runs,
+ * e.g. into a `std::back_inserter`. Raw pointers are excluded, as nothing
+ * would bound the write; arrays go to the bounded overload above.
+ * 
+ * @tparam OutputIt An output iterator accepting `char`, other than a pointer.
+ * @param root The root node of the AST to serialize.
+ * @param out The iterator receiving the output.
+ * @param pretty If true, formats the output with indentation and newlines.
+ * @return OutputIt The iterator one past the last character written.
+ */
+template<std::output_iterator<char> OutputIt>
+    requires (!std::is_pointer_v<std::decay_t<OutputIt>>)
+OutputIt write(const Node* root, OutputIt out, bool pretty = false) {
+    IteratorSink<OutputIt> sink(std::move(out));
+    write(root, sink, pretty);
+    return sink.iterator();
+}
+
 /**
  * @brief Read a file into arena-managed memory and parse it
  * 
+ * The file's bytes are copied into the arena so that the tree depends on
+ * nothing else; for large files prefer parse_document_file(), which parses
+ * from a memory mapping without the copy.
+ * 
  * This function:
  * 1. Reads the entire file into a buffer
  * 2. Allocates the buffer in the provided arena
@@ -16,10 +16,23 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
 #include <vector>
 
 namespace json {
 
+/**
+ * @brief Memory usage statistics of an Arena.
+ */
+struct ArenaStats {
+    size_t allocated;   ///< Bytes handed out to callers
+    size_t padding;     ///< Bytes lost to alignment padding
+    size_t reserved;    ///< Bytes currently held from the upstream resource
+    size_t blocks;      ///< Number of blocks currently held (including large ones)
+};
+
 /**
  * @brief A memory arena for efficient allocation of small objects.
  * 
@@ -27,22 +40,40 @@ namespace json {
  * (pointer bump) and deallocation happens all at once when the Arena is destroyed.
  * This is ideal for constructing ASTs where nodes are allocated sequentially
  * and destroyed together.
+ * 
+ * An optional byte budget caps how much memory the arena may reserve from its
+ * upstream resource. Once the budget is exhausted, allocations return nullptr
+ * instead of growing, and the parser reports ErrorCode::OutOfMemory.
  */
 class Arena {
 public:
     /// Default size for memory blocks (64KB).
     static constexpr size_t DefaultBlockSize = 64 * 1024;
 
+    /// Budget value meaning "no limit".
+    static constexpr size_t Unlimited = static_cast<size_t>(-1);
+
     /**
      * @brief Constructs a new Arena.
      * 
      * @param block_size The size of each memory block in bytes. Defaults to 64KB.
+     * @param upstream The memory resource blocks are obtained from. Defaults to
+     *                 the global `::operator new`/`delete`.
      */
-    explicit Arena(size_t block_size = DefaultBlockSize)
-        : block_size_(block_size), current_(nullptr), remaining_(0) {
+    explicit Arena(size_t block_size = DefaultBlockSize,
+                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : block_size_(block_size), upstream_(upstream), blocks_(upstream), large_(upstream) {
         allocate_block();
     }
 
+    /**
+     * @brief Constructs a new Arena with the default block size.
+     * 
+     * @param upstream The memory resource blocks are obtained from.
+     */
+    explicit Arena(std::pmr::memory_resource* upstream)
+        : Arena(DefaultBlockSize, upstream) {}
+
     /**
      * @brief Destroys the Arena and frees all allocated memory blocks.
      * 
@@ -50,15 +81,57 @@ public:
      * This is suitable for POD types or types where destruction is not strictly required.
      */
     ~Arena() {
-        for (auto* block : blocks_) {
-            ::operator delete(block);
+        release_large();
+        for (const auto& block : blocks_) {
+            upstream_->deallocate(block.data, block.size, BlockAlignment);
         }
     }
 
-    // Non-copyable, non-movable
+    // Non-copyable
     Arena(const Arena&) = delete;
     Arena& operator=(const Arena&) = delete;
 
+    /**
+     * @brief Moves all blocks out of another arena.
+     * 
+     * Memory handed out by `other` stays valid and is now owned by this
+     * arena. `other` is left empty but usable; it obtains a new block from
+     * its upstream on the next allocation.
+     * 
+     * @param other The arena to take ownership from.
+     */
+    Arena(Arena&& other) noexcept
+        : block_size_(other.block_size_),
+          current_(std::exchange(other.current_, nullptr)),
+          remaining_(std::exchange(other.remaining_, 0)),
+          upstream_(other.upstream_),
+          blocks_(std::move(other.blocks_)),
+          large_(std::move(other.large_)),
+          next_block_(std::exchange(other.next_block_, 0)),
+          budget_(other.budget_),
+          padding_(std::exchange(other.padding_, 0)),
+          retired_(std::exchange(other.retired_, 0)),
+          large_bytes_(std::exchange(other.large_bytes_, 0)),
+          large_reserved_(std::exchange(other.large_reserved_, 0)) {
+        other.blocks_.clear();
+        other.large_.clear();
+    }
+
+    /**
+     * @brief Frees this arena's memory and takes ownership of another's.
+     * 
+     * @param other The arena to take ownership from.
+     * @return Arena& Reference to self.
+     */
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            // Rebuilding in place keeps the block vectors on other's upstream
+            this->~Arena();
+            ::new (static_cast<void*>(this)) Arena(std::move(other));
+        }
+        return *this;
+    }
+
     /**
      * @brief Allocates memory for objects of type T.
      * 
@@ -66,37 +139,34 @@ public:
      * 
      * @tparam T The type of object to allocate.
      * @param count The number of objects to allocate. Defaults to 1.
-     * @return T* Pointer to the allocated memory.
+     * @return T* Pointer to the allocated memory, or nullptr if the budget is exhausted.
      */
     template<typename T>
     [[nodiscard]] T* alloc(size_t count = 1) {
-        constexpr size_t alignment = alignof(T);
-        size_t size = sizeof(T) * count;
-        
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Allocates raw memory with the given alignment.
+     * 
+     * @param size Number of bytes to allocate.
+     * @param alignment Required alignment (a power of two).
+     * @return void* Pointer to the allocated memory, or nullptr if the budget is exhausted.
+     */
+    [[nodiscard]] void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
         // Align current pointer
         uintptr_t addr = reinterpret_cast<uintptr_t>(current_);
         uintptr_t aligned = (addr + alignment - 1) & ~(alignment - 1);
         size_t padding = aligned - addr;
 
         if (padding + size > remaining_) [[unlikely]] {
-            if (size > block_size_) {
-                // Large allocation - dedicated block
-                void* large = ::operator new(size);
-                blocks_.push_back(static_cast<uint8_t*>(large));
-                return static_cast<T*>(large);
-            }
-            allocate_block();
-            return alloc<T>(count);
+            return allocate_slow(size, alignment);
         }
 
-        current_ += padding;
-        remaining_ -= padding;
-
-        T* result = reinterpret_cast<T*>(current_);
-        current_ += size;
-        remaining_ -= size;
-
-        return result;
+        current_ += padding + size;
+        remaining_ -= padding + size;
+        padding_ += padding;
+        return reinterpret_cast<void*>(aligned);
     }
 
     /**
@@ -104,27 +174,171 @@ public:
      * 
      * This allows reusing the allocated blocks for new data without
      * the cost of freeing and re-allocating memory from the OS.
+     * Dedicated blocks of large allocations are returned to the upstream.
      */
     void reset() {
+        release_large();
+        padding_ = 0;
+        retired_ = 0;
         if (!blocks_.empty()) {
-            current_ = blocks_[0];
+            current_ = blocks_[0].data;
             remaining_ = block_size_;
+            next_block_ = 1;
         }
     }
 
+    /**
+     * @brief Sets the maximum number of bytes the arena may hold from upstream.
+     * 
+     * Blocks already held count against the budget; a budget below the
+     * current reservation only prevents further growth.
+     * 
+     * @param max_bytes The budget in bytes, or Arena::Unlimited.
+     */
+    void set_budget(size_t max_bytes) noexcept { budget_ = max_bytes; }
+
+    /// Gets the current byte budget (Arena::Unlimited if none).
+    [[nodiscard]] size_t budget() const noexcept { return budget_; }
+
+    /**
+     * @brief Reports how much memory the arena uses.
+     * 
+     * @return ArenaStats Allocation, padding and reservation counters.
+     */
+    [[nodiscard]] ArenaStats stats() const noexcept {
+        size_t consumed = retired_ + large_bytes_;
+        if (current_) consumed += block_size_ - remaining_;
+        return ArenaStats{
+            consumed - padding_,
+            padding_,
+            reserved(),
+            blocks_.size() + large_.size()
+        };
+    }
+
+    /**
+     * @brief Gets the memory resource the arena obtains its blocks from.
+     * 
+     * Components that need short-lived scratch memory next to the arena
+     * (e.g. the parser's element stacks) allocate from this resource, so
+     * all memory used by a parse is steered to the same allocator.
+     * 
+     * @return std::pmr::memory_resource* The upstream resource.
+     */
+    [[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
 private:
-    /// Allocates a new memory block from the system.
-    void allocate_block() {
-        void* block = ::operator new(block_size_);
-        blocks_.push_back(static_cast<uint8_t*>(block));
-        current_ = static_cast<uint8_t*>(block);
+    /// Alignment of every block requested from upstream.
+    static constexpr size_t BlockAlignment = alignof(std::max_align_t);
+
+    struct Block {
+        uint8_t* data;
+        size_t size;
+    };
+
+    void* allocate_slow(size_t size, size_t alignment) {
+        if (size + alignment > block_size_) {
+            // Large allocation - dedicated block, keep bumping in the current one.
+            // Over-aligned requests are satisfied by over-allocating.
+            size_t extra = alignment > BlockAlignment ? alignment : 0;
+            size_t bytes = size + extra;
+            if (!within_budget(bytes)) return nullptr;
+
+            auto* large = static_cast<uint8_t*>(upstream_->allocate(bytes, BlockAlignment));
+            large_.push_back(Block{large, bytes});
+            large_reserved_ += bytes;
+
+            uintptr_t addr = reinterpret_cast<uintptr_t>(large);
+            uintptr_t aligned = (addr + alignment - 1) & ~(alignment - 1);
+            large_bytes_ += size + (aligned - addr);
+            padding_ += aligned - addr;
+            return reinterpret_cast<void*>(aligned);
+        }
+        if (!allocate_block()) return nullptr;
+        return allocate(size, alignment);
+    }
+
+    /// Moves to the next retained block, or allocates a new one from upstream.
+    bool allocate_block() {
+        if (next_block_ == blocks_.size()) {
+            if (!within_budget(block_size_)) return false;
+            void* block = upstream_->allocate(block_size_, BlockAlignment);
+            blocks_.push_back(Block{static_cast<uint8_t*>(block), block_size_});
+        }
+        if (current_) retired_ += block_size_ - remaining_;
+        current_ = blocks_[next_block_++].data;
         remaining_ = block_size_;
+        return true;
+    }
+
+    void release_large() {
+        for (const auto& block : large_) {
+            upstream_->deallocate(block.data, block.size, BlockAlignment);
+        }
+        large_.clear();
+        large_reserved_ = 0;
+        large_bytes_ = 0;
+    }
+
+    size_t reserved() const noexcept { return blocks_.size() * block_size_ + large_reserved_; }
+
+    bool within_budget(size_t bytes) const noexcept {
+        size_t held = reserved();
+        return held <= budget_ && bytes <= budget_ - held;
     }
 
     size_t block_size_;
-    uint8_t* current_;
-    size_t remaining_;
-    std::vector<uint8_t*> blocks_;
+    uint8_t* current_ = nullptr;
+    size_t remaining_ = 0;
+    std::pmr::memory_resource* upstream_;
+    std::pmr::vector<Block> blocks_;    ///< Fixed-size blocks, reused after reset()
+    std::pmr::vector<Block> large_;     ///< Dedicated blocks for large allocations
+    size_t next_block_ = 0;             ///< Index of the next block to bump into
+    size_t budget_ = Unlimited;
+    size_t padding_ = 0;                ///< Alignment padding since the last reset
+    size_t retired_ = 0;                ///< Bytes consumed in blocks left behind
+    size_t large_bytes_ = 0;            ///< Bytes consumed in large blocks
+    size_t large_reserved_ = 0;         ///< Bytes held in large blocks
+};
+
+/**
+ * @brief Adapter exposing an Arena as a `std::pmr::memory_resource`.
+ * 
+ * Lets standard pmr containers allocate from an arena. Deallocation is a
+ * no-op; memory is reclaimed when the underlying Arena is reset or destroyed.
+ * 
+ * Example:
+ *   Arena arena;
+ *   ArenaResource resource(arena);
+ *   std::pmr::vector<Node*> scratch(&resource);
+ */
+class ArenaResource final : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructs an adapter over the given arena.
+     * 
+     * @param arena The arena to allocate from. Must outlive the adapter.
+     */
+    explicit ArenaResource(Arena& arena) noexcept : arena_(arena) {}
+
+    /// Gets the underlying arena.
+    [[nodiscard]] Arena& arena() const noexcept { return arena_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = arena_.allocate(bytes, alignment);
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        auto* resource = dynamic_cast<const ArenaResource*>(&other);
+        return resource && &resource->arena_ == &arena_;
+    }
+
+    Arena& arena_;
 };
 
 } // namespace json
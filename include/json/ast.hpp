@@ -34,6 +34,13 @@ enum class NodeType : uint8_t {
     Object  ///< JSON object (key-value pairs)
 };
 
+/**
+ * @brief Bits stored in Node::flags.
+ */
+enum class NodeFlag : uint8_t {
+    Verbatim = 1 << 0   ///< String contains no quote, backslash or control character
+};
+
 struct Node;
 
 /**
@@ -207,6 +214,15 @@ struct ObjectView {
  */
 struct Node {
     NodeType type; ///< The type of value stored in this node
+
+    /**
+     * @brief NodeFlag bits (stored in what would otherwise be padding).
+     * 
+     * The parser marks strings that can be written without escaping as
+     * NodeFlag::Verbatim. The factory functions clear all flags; code that
+     * assigns `string_val` directly must clear them as well.
+     */
+    uint8_t flags;
     
     /**
      * @brief Union of all possible value types.
@@ -225,7 +241,7 @@ struct Node {
      * @return Node A new node of type Null.
      */
     static Node make_null() {
-        return Node{.type = NodeType::Null, .bool_val = false};
+        return Node{.type = NodeType::Null, .flags = 0, .bool_val = false};
     }
 
     /**
@@ -234,7 +250,7 @@ struct Node {
      * @return Node A new node of type Bool.
      */
     static Node make_bool(bool val) {
-        return Node{.type = NodeType::Bool, .bool_val = val};
+        return Node{.type = NodeType::Bool, .flags = 0, .bool_val = val};
     }
 
     /**
@@ -243,7 +259,7 @@ struct Node {
      * @return Node A new node of type Number.
      */
     static Node make_number(double val) {
-        return Node{.type = NodeType::Number, .number_val = val};
+        return Node{.type = NodeType::Number, .flags = 0, .number_val = val};
     }
 
     /**
@@ -253,7 +269,7 @@ struct Node {
      * @return Node A new node of type String.
      */
     static Node make_string(const char* data, size_t size) {
-        return Node{.type = NodeType::String, .string_val = {data, size}};
+        return Node{.type = NodeType::String, .flags = 0, .string_val = {data, size}};
     }
 
     /**
@@ -263,7 +279,7 @@ struct Node {
      * @return Node A new node of type Array.
      */
     static Node make_array(Node** data, size_t size) {
-        return Node{.type = NodeType::Array, .array_val = {data, size}};
+        return Node{.type = NodeType::Array, .flags = 0, .array_val = {data, size}};
     }
 
     /**
@@ -273,7 +289,7 @@ struct Node {
      * @return Node A new node of type Object.
      */
     static Node make_object(ObjectPair* data, size_t size) {
-        return Node{.type = NodeType::Object, .object_val = {data, size}};
+        return Node{.type = NodeType::Object, .flags = 0, .object_val = {data, size}};
     }
 
     /// @brief Checks if the node is Null.
@@ -288,6 +304,8 @@ struct Node {
     constexpr bool is_array() const { return type == NodeType::Array; }
     /// @brief Checks if the node is an Object.
     constexpr bool is_object() const { return type == NodeType::Object; }
+    /// @brief Checks if a flag is set on the node.
+    constexpr bool has_flag(NodeFlag flag) const { return flags & static_cast<uint8_t>(flag); }
 
     /**
      * @brief Attempts to access the node as a boolean.
@@ -0,0 +1,121 @@
+/**
+ * @file async_loader.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Asynchronous JSON File Loading API
+ *
+ * This file defines AsyncLoader, a worker pool that loads and parses many
+ * files concurrently.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "arena.hpp"
+#include "document.hpp"
+#include "error.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace json {
+
+/**
+ * @brief Loads and parses files on a pool of worker threads.
+ *
+ * Each request is queued and picked up by the next free worker, which maps
+ * the file (see parse_document_file()) and parses it into a Document. With
+ * more workers than cores, some of them wait for the disk while the rest
+ * parse, so I/O latency overlaps with parsing. Results are delivered
+ * through a future or a callback that runs on the worker thread.
+ *
+ * The destructor finishes all queued requests before joining the workers.
+ *
+ * Example:
+ *   AsyncLoader loader;
+ *   std::vector<std::future<Result<Document>>> results;
+ *   for (const auto& path : paths) results.push_back(loader.load(path));
+ *   for (auto& result : results) use(result.get());
+ */
+class AsyncLoader {
+public:
+    /// Callback receiving the path and the outcome of a load.
+    using Callback = std::function<void(const std::string& path, Result<Document> result)>;
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threads Number of workers; 0 uses twice the hardware concurrency
+     *                so that blocked reads do not leave cores idle.
+     * @param block_size Block size of each document's arena.
+     * @param upstream Memory resource for each document's arena; must be
+     *                 thread-safe (e.g. the default or a ConcurrentArena).
+     */
+    explicit AsyncLoader(unsigned threads = 0,
+                         size_t block_size = Arena::DefaultBlockSize,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    /// Completes all queued loads and joins the workers.
+    ~AsyncLoader();
+
+    AsyncLoader(const AsyncLoader&) = delete;
+    AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+    /**
+     * @brief Queues a file and returns a future for its document.
+     *
+     * @param path Path to the JSON file.
+     * @return std::future<Result<Document>> The parsed document or an error.
+     */
+    std::future<Result<Document>> load(std::string path);
+
+    /**
+     * @brief Queues a file and calls `callback` with the outcome.
+     *
+     * The callback runs on a worker thread and must not throw.
+     *
+     * @param path Path to the JSON file.
+     * @param callback The function receiving the result.
+     */
+    void load(std::string path, Callback callback);
+
+    /// Blocks until every queued load has completed.
+    void wait();
+
+    /// Gets the number of loads queued or in progress.
+    [[nodiscard]] size_t pending() const;
+
+    /// Gets the number of worker threads.
+    [[nodiscard]] size_t threads() const noexcept { return workers_.size(); }
+
+private:
+    struct Job {
+        std::string path;
+        std::function<void(const std::string&, Result<Document>&&)> done;
+    };
+
+    void enqueue(Job job);
+    void run();
+    Result<Document> load_now(const std::string& path) const;
+
+    size_t block_size_;
+    std::pmr::memory_resource* upstream_;
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;     ///< Signals queued work or shutdown
+    std::condition_variable idle_;      ///< Signals that pending_ reached zero
+    std::deque<Job> queue_;
+    size_t pending_ = 0;                ///< Queued plus running jobs
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace json
@@ -0,0 +1,245 @@
+/**
+ * @file async_parse.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Coroutine-based JSON Parsing API
+ *
+ * This file defines an awaitable Task type and parse_async(), which parses
+ * input pulled from an asynchronous byte source, suspending while the
+ * source has no data.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "arena.hpp"
+#include "error.hpp"
+#include "stream_parser.hpp"
+#include <concepts>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace json {
+
+/**
+ * @brief Lazily started coroutine producing a value of type `T`.
+ *
+ * A Task does not run until it is awaited or start() is called. Awaiting
+ * it from another coroutine resumes the awaiter when the task completes;
+ * a task started with start() can be polled with done() and read with
+ * get(). Exceptions escaping the coroutine are rethrown by get() or by
+ * the co_await expression.
+ */
+template <typename T>
+class Task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::exception_ptr exception;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct FinalAwaiter {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    // Symmetric transfer back to the awaiter, if any
+                    auto continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+
+        template <typename U>
+            requires std::convertible_to<U, T>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    /// Runs the coroutine until its first suspension point.
+    void start() {
+        if (handle_ && !handle_.done()) handle_.resume();
+    }
+
+    /// Checks whether the coroutine has completed.
+    [[nodiscard]] bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    /**
+     * @brief Gets the result of a completed task.
+     *
+     * @return T& The value passed to co_return.
+     */
+    T& get() & {
+        auto& promise = handle_.promise();
+        if (promise.exception) std::rethrow_exception(promise.exception);
+        return *promise.value;
+    }
+
+    /// Moves the result out of a completed task.
+    T get() && { return std::move(get()); }
+
+    bool await_ready() const noexcept { return done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+
+    T await_resume() { return std::move(get()); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief An asynchronous source of input chunks.
+ *
+ * `co_await source.next()` yields the next chunk, or std::nullopt at the
+ * end of input. The chunk must stay valid until next() is called again.
+ */
+template <typename S>
+concept AsyncByteSource = requires(S& source) {
+    source.next();
+};
+
+/**
+ * @brief In-memory AsyncByteSource fed by a producer.
+ *
+ * A consumer awaiting next() while no chunk is queued is suspended and
+ * resumed inline by the following push() or close(), so no thread is
+ * held while waiting. The channel is single-threaded: push() and close()
+ * must run on the thread driving the consumer, e.g. an event loop.
+ */
+class ChunkChannel {
+public:
+    /// Awaitable returned by next().
+    class NextChunk {
+    public:
+        explicit NextChunk(ChunkChannel& channel) noexcept : channel_(channel) {}
+
+        bool await_ready() const noexcept { return !channel_.queue_.empty() || channel_.closed_; }
+
+        void await_suspend(std::coroutine_handle<> consumer) noexcept { channel_.consumer_ = consumer; }
+
+        std::optional<std::span<const char>> await_resume() {
+            if (channel_.queue_.empty()) return std::nullopt;
+            channel_.current_ = std::move(channel_.queue_.front());
+            channel_.queue_.pop_front();
+            return std::span<const char>(channel_.current_.data(), channel_.current_.size());
+        }
+
+    private:
+        ChunkChannel& channel_;
+    };
+
+    /// Waits for the next chunk; std::nullopt once closed and drained.
+    [[nodiscard]] NextChunk next() noexcept { return NextChunk(*this); }
+
+    /**
+     * @brief Queues a copy of `chunk` and resumes a waiting consumer.
+     *
+     * @param chunk The bytes following those pushed before.
+     */
+    void push(std::string_view chunk) {
+        queue_.emplace_back(chunk);
+        wake();
+    }
+
+    /// Marks the end of input and resumes a waiting consumer.
+    void close() {
+        closed_ = true;
+        wake();
+    }
+
+    /// Checks whether a consumer is suspended waiting for input.
+    [[nodiscard]] bool waiting() const noexcept { return static_cast<bool>(consumer_); }
+
+private:
+    void wake() {
+        if (auto consumer = std::exchange(consumer_, {})) consumer.resume();
+    }
+
+    std::deque<std::string> queue_;
+    std::string current_;               ///< Chunk handed out by the last next()
+    std::coroutine_handle<> consumer_;
+    bool closed_ = false;
+};
+
+/**
+ * @brief Parses input from an asynchronous source, delivering events.
+ *
+ * The coroutine suspends whenever the source has no data and resumes when
+ * a chunk arrives; chunks may be split at any byte.
+ *
+ * @param source The source of input chunks. Must outlive the task.
+ * @param handler The event receiver. Must outlive the task.
+ * @param multiple_documents Accept a sequence of top-level values (NDJSON).
+ * @return Task<Result<void>> Success, or the first error.
+ */
+template <AsyncByteSource Source>
+Task<Result<void>> parse_async(Source& source, EventHandler& handler, bool multiple_documents = false) {
+    StreamParser parser(handler, multiple_documents);
+    while (std::optional<std::span<const char>> chunk = co_await source.next()) {
+        if (auto fed = parser.feed(*chunk); !fed) co_return fed;
+    }
+    co_return parser.finish();
+}
+
+/**
+ * @brief Parses input from an asynchronous source into a tree.
+ *
+ * @param source The source of input chunks. Must outlive the task.
+ * @param arena The arena receiving nodes and string contents.
+ * @return Task<Result<Node*>> The root node, or an error.
+ */
+template <AsyncByteSource Source>
+Task<Result<Node*>> parse_async(Source& source, Arena& arena) {
+    DomBuilder builder(arena);
+    if (Result<void> parsed = co_await parse_async(source, builder); !parsed) {
+        Error error = parsed.error();
+        if (error.code == ErrorCode::Cancelled && builder.out_of_memory()) {
+            co_return std::unexpected(Error{ErrorCode::OutOfMemory, error.offset,
+                                            error_message(ErrorCode::OutOfMemory)});
+        }
+        co_return std::unexpected(error);
+    }
+    co_return builder.root();
+}
+
+} // namespace json
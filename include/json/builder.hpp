@@ -32,19 +32,36 @@ class ArrayBuilder;
  * 
  * @param arena The arena to allocate memory from.
  * @param str The string to copy.
- * @return const char* Pointer to the null-terminated string in the arena.
+ * @return const char* Pointer to the string in the arena, or nullptr if the
+ *         arena's budget is exhausted.
  */
 inline const char* arena_copy_string(Arena& arena, std::string_view str) {
+    if (str.empty()) return "";
     char* buffer = arena.alloc<char>(str.size());
-    std::memcpy(buffer, str.data(), str.size());
+    if (buffer) std::memcpy(buffer, str.data(), str.size());
     return buffer;
 }
 
+/**
+ * @brief Helper to allocate a node in the arena.
+ * 
+ * @param arena The arena to allocate memory from.
+ * @param value The node to copy into the arena.
+ * @return Node* Pointer to the new node, or nullptr if the arena's budget
+ *         is exhausted.
+ */
+inline Node* arena_new_node(Arena& arena, const Node& value) {
+    Node* node = arena.alloc<Node>();
+    if (node) *node = value;
+    return node;
+}
+
 /**
  * @brief Safe builder for JSON arrays
  * 
  * Provides a fluent interface for constructing JSON arrays.
- * Allocates nodes from the provided Arena.
+ * Allocates nodes from the provided Arena. If the arena's budget runs out,
+ * the builder is marked failed and build() returns nullptr.
  * 
  * Example:
  *   ArrayBuilder arr(arena);
@@ -58,7 +75,7 @@ public:
      * 
      * @param arena The memory arena used for node allocation.
      */
-    explicit ArrayBuilder(Arena& arena) : arena_(arena) {}
+    explicit ArrayBuilder(Arena& arena) : arena_(arena), elements_(arena.upstream()) {}
 
     /**
      * @brief Appends a null value to the array.
@@ -67,10 +84,7 @@ public:
      * @return ArrayBuilder& Reference to self for chaining.
      */
     ArrayBuilder& add(std::nullptr_t) {
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_null();
-        elements_.push_back(node);
-        return *this;
+        return add(arena_new_node(arena_, Node::make_null()));
     }
 
     /**
@@ -80,10 +94,7 @@ public:
      * @return ArrayBuilder& Reference to self for chaining.
      */
     ArrayBuilder& add(bool value) {
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_bool(value);
-        elements_.push_back(node);
-        return *this;
+        return add(arena_new_node(arena_, Node::make_bool(value)));
     }
 
     /**
@@ -93,10 +104,7 @@ public:
      * @return ArrayBuilder& Reference to self for chaining.
      */
     ArrayBuilder& add(double value) {
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_number(value);
-        elements_.push_back(node);
-        return *this;
+        return add(arena_new_node(arena_, Node::make_number(value)));
     }
 
     /**
@@ -117,10 +125,7 @@ public:
      */
     ArrayBuilder& add(std::string_view value) {
         const char* data = arena_copy_string(arena_, value);
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_string(data, value.size());
-        elements_.push_back(node);
-        return *this;
+        return add(data ? arena_new_node(arena_, Node::make_string(data, value.size())) : nullptr);
     }
 
     /**
@@ -136,12 +141,17 @@ public:
     /**
      * @brief Appends an existing Node to the array.
      * 
+     * A null node, as returned by a build() or make_*() call that ran out
+     * of memory, marks the builder failed.
+     * 
      * @param node Pointer to the Node to append.
      * @return ArrayBuilder& Reference to self for chaining.
      */
     ArrayBuilder& add(Node* node) {
         if (node) {
             elements_.push_back(node);
+        } else {
+            failed_ = true;
         }
         return *this;
     }
@@ -149,16 +159,22 @@ public:
     /**
      * @brief Finalizes the array construction.
      * 
-     * @return Node* Pointer to the newly created Array Node.
+     * @return Node* Pointer to the newly created Array Node, or nullptr if
+     *         the arena ran out of memory at any point.
      */
     Node* build() {
-        Node** arr = arena_.alloc<Node*>(elements_.size());
+        if (failed_) return nullptr;
+        Node** arr = elements_.empty() ? nullptr : arena_.alloc<Node*>(elements_.size());
+        if (!arr && !elements_.empty()) {
+            failed_ = true;
+            return nullptr;
+        }
         for (size_t i = 0; i < elements_.size(); ++i) {
             arr[i] = elements_[i];
         }
         
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_array(arr, elements_.size());
+        Node* node = arena_new_node(arena_, Node::make_array(arr, elements_.size()));
+        if (!node) failed_ = true;
         return node;
     }
 
@@ -169,16 +185,25 @@ public:
      */
     size_t size() const { return elements_.size(); }
 
+    /**
+     * @brief Checks whether an allocation failed; once set, it stays set.
+     * 
+     * @return true If the arena's budget ran out while building.
+     */
+    bool failed() const { return failed_; }
+
 private:
     Arena& arena_;
-    std::vector<Node*> elements_;
+    std::pmr::vector<Node*> elements_;
+    bool failed_ = false;
 };
 
 /**
  * @brief Safe builder for JSON objects
  * 
  * Provides a fluent interface for constructing JSON objects.
- * Allocates nodes from the provided Arena.
+ * Allocates nodes from the provided Arena. If the arena's budget runs out,
+ * the builder is marked failed and build() returns nullptr.
  * 
  * Example:
  *   ObjectBuilder obj(arena);
@@ -194,7 +219,7 @@ public:
      * 
      * @param arena The memory arena used for node allocation.
      */
-    explicit ObjectBuilder(Arena& arena) : arena_(arena) {}
+    explicit ObjectBuilder(Arena& arena) : arena_(arena), pairs_(arena.upstream()) {}
 
     /**
      * @brief Adds a null value with the specified key.
@@ -204,10 +229,7 @@ public:
      * @return ObjectBuilder& Reference to self for chaining.
      */
     ObjectBuilder& add(std::string_view key, std::nullptr_t) {
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_null();
-        add_pair(key, node);
-        return *this;
+        return add(key, arena_new_node(arena_, Node::make_null()));
     }
 
     /**
@@ -218,10 +240,7 @@ public:
      * @return ObjectBuilder& Reference to self for chaining.
      */
     ObjectBuilder& add(std::string_view key, bool value) {
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_bool(value);
-        add_pair(key, node);
-        return *this;
+        return add(key, arena_new_node(arena_, Node::make_bool(value)));
     }
 
     /**
@@ -232,10 +251,7 @@ public:
      * @return ObjectBuilder& Reference to self for chaining.
      */
     ObjectBuilder& add(std::string_view key, double value) {
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_number(value);
-        add_pair(key, node);
-        return *this;
+        return add(key, arena_new_node(arena_, Node::make_number(value)));
     }
 
     /**
@@ -258,10 +274,7 @@ public:
      */
     ObjectBuilder& add(std::string_view key, std::string_view value) {
         const char* data = arena_copy_string(arena_, value);
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_string(data, value.size());
-        add_pair(key, node);
-        return *this;
+        return add(key, data ? arena_new_node(arena_, Node::make_string(data, value.size())) : nullptr);
     }
 
     /**
@@ -278,6 +291,9 @@ public:
     /**
      * @brief Adds an existing Node with the specified key.
      * 
+     * A null node, as returned by a build() or make_*() call that ran out
+     * of memory, marks the builder failed.
+     * 
      * @param key The object key.
      * @param node Pointer to the Node to add.
      * @return ObjectBuilder& Reference to self for chaining.
@@ -285,6 +301,8 @@ public:
     ObjectBuilder& add(std::string_view key, Node* node) {
         if (node) {
             add_pair(key, node);
+        } else {
+            failed_ = true;
         }
         return *this;
     }
@@ -292,16 +310,22 @@ public:
     /**
      * @brief Finalizes the object construction.
      * 
-     * @return Node* Pointer to the newly created Object Node.
+     * @return Node* Pointer to the newly created Object Node, or nullptr if
+     *         the arena ran out of memory at any point.
      */
     Node* build() {
-        ObjectPair* obj = arena_.alloc<ObjectPair>(pairs_.size());
+        if (failed_) return nullptr;
+        ObjectPair* obj = pairs_.empty() ? nullptr : arena_.alloc<ObjectPair>(pairs_.size());
+        if (!obj && !pairs_.empty()) {
+            failed_ = true;
+            return nullptr;
+        }
         for (size_t i = 0; i < pairs_.size(); ++i) {
             obj[i] = pairs_[i];
         }
         
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_object(obj, pairs_.size());
+        Node* node = arena_new_node(arena_, Node::make_object(obj, pairs_.size()));
+        if (!node) failed_ = true;
         return node;
     }
 
@@ -312,14 +336,26 @@ public:
      */
     size_t size() const { return pairs_.size(); }
 
+    /**
+     * @brief Checks whether an allocation failed; once set, it stays set.
+     * 
+     * @return true If the arena's budget ran out while building.
+     */
+    bool failed() const { return failed_; }
+
 private:
     void add_pair(std::string_view key, Node* value) {
         const char* key_data = arena_copy_string(arena_, key);
+        if (!key_data) {
+            failed_ = true;
+            return;
+        }
         pairs_.push_back(ObjectPair{{key_data, key.size()}, value});
     }
 
     Arena& arena_;
-    std::vector<ObjectPair> pairs_;
+    std::pmr::vector<ObjectPair> pairs_;
+    bool failed_ = false;
 };
 
 // Convenience factory functions
@@ -351,7 +387,7 @@ inline ArrayBuilder build_array(Arena& arena) {
  * 
  * @param arena The arena to use for allocation.
  * @param values The list of double values.
- * @return Node* Pointer to the created Array Node.
+ * @return Node* Pointer to the created Array Node, or nullptr if the arena is out of memory.
  */
 inline Node* build_array(Arena& arena, std::initializer_list<double> values) {
     ArrayBuilder builder(arena);
@@ -366,7 +402,7 @@ inline Node* build_array(Arena& arena, std::initializer_list<double> values) {
  * 
  * @param arena The arena to use for allocation.
  * @param values The list of string values.
- * @return Node* Pointer to the created Array Node.
+ * @return Node* Pointer to the created Array Node, or nullptr if the arena is out of memory.
  */
 inline Node* build_array(Arena& arena, std::initializer_list<const char*> values) {
     ArrayBuilder builder(arena);
@@ -380,12 +416,10 @@ inline Node* build_array(Arena& arena, std::initializer_list<const char*> values
  * @brief Creates a null node.
  * 
  * @param arena The arena to use for allocation.
- * @return Node* Pointer to the created Null Node.
+ * @return Node* Pointer to the created Null Node, or nullptr if the arena is out of memory.
  */
 inline Node* make_null(Arena& arena) {
-    Node* node = arena.alloc<Node>();
-    *node = Node::make_null();
-    return node;
+    return arena_new_node(arena, Node::make_null());
 }
 
 /**
@@ -393,12 +427,10 @@ inline Node* make_null(Arena& arena) {
  * 
  * @param arena The arena to use for allocation.
  * @param value The boolean value.
- * @return Node* Pointer to the created Bool Node.
+ * @return Node* Pointer to the created Bool Node, or nullptr if the arena is out of memory.
  */
 inline Node* make_bool(Arena& arena, bool value) {
-    Node* node = arena.alloc<Node>();
-    *node = Node::make_bool(value);
-    return node;
+    return arena_new_node(arena, Node::make_bool(value));
 }
 
 /**
@@ -406,12 +438,10 @@ inline Node* make_bool(Arena& arena, bool value) {
  * 
  * @param arena The arena to use for allocation.
  * @param value The numeric value.
- * @return Node* Pointer to the created Number Node.
+ * @return Node* Pointer to the created Number Node, or nullptr if the arena is out of memory.
  */
 inline Node* make_number(Arena& arena, double value) {
-    Node* node = arena.alloc<Node>();
-    *node = Node::make_number(value);
-    return node;
+    return arena_new_node(arena, Node::make_number(value));
 }
 
 /**
@@ -419,13 +449,11 @@ inline Node* make_number(Arena& arena, double value) {
  * 
  * @param arena The arena to use for allocation.
  * @param value The string value.
- * @return Node* Pointer to the created String Node.
+ * @return Node* Pointer to the created String Node, or nullptr if the arena is out of memory.
  */
 inline Node* make_string(Arena& arena, std::string_view value) {
     const char* data = arena_copy_string(arena, value);
-    Node* node = arena.alloc<Node>();
-    *node = Node::make_string(data, value.size());
-    return node;
+    return data ? arena_new_node(arena, Node::make_string(data, value.size())) : nullptr;
 }
 
 } // namespace json
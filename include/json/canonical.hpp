@@ -0,0 +1,104 @@
+/**
+ * @file canonical.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief JSON Canonicalization (RFC 8785) API
+ *
+ * This file defines a writer producing the JSON Canonicalization Scheme
+ * form of a tree, suitable for hashing and signing.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "ast.hpp"
+#include "error.hpp"
+#include "sink.hpp"
+#include "writer.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+/**
+ * @brief Formats a finite number the way ECMAScript's Number::toString does.
+ *
+ * Uses the shortest digits that parse back to the same double, plain
+ * notation for decimal exponents from -6 to 20, and `1e+21` style
+ * exponents otherwise. Negative zero is written as `0`.
+ *
+ * @param value The number to format. Must be finite.
+ * @param out Destination with room for at least MaxNumberLength characters.
+ * @return char* One past the last character written.
+ */
+char* format_canonical_number(double value, char* out) noexcept;
+
+/**
+ * @brief Checks whether `a` sorts before `b` when compared as UTF-16 code units.
+ *
+ * Both strings are UTF-8. The result equals byte order except that code
+ * points above U+FFFF (surrogate pairs in UTF-16) sort before U+E000..U+FFFF.
+ */
+bool utf16_less(std::string_view a, std::string_view b) noexcept;
+
+/**
+ * @brief Serializes trees in RFC 8785 canonical form.
+ *
+ * Output has no insignificant whitespace, object members sorted by the
+ * UTF-16 code units of their keys, ECMAScript number formatting and the
+ * minimal string escaping also used by Writer. The tree is not modified:
+ * member order is sorted in a scratch buffer that is reused across calls.
+ * NaN and infinities have no canonical form and are rejected.
+ */
+class CanonicalWriter {
+public:
+    /**
+     * @brief Serializes a tree into a string.
+     *
+     * @param root The root node of the tree.
+     * @return Result<std::string> The canonical text, or ErrorCode::InvalidNumber
+     *         if the tree holds a non-finite number.
+     */
+    Result<std::string> write(const Node* root);
+
+    /**
+     * @brief Serializes a tree into a sink.
+     *
+     * @param root The root node of the tree.
+     * @param out The sink receiving the output; flushed when done.
+     * @return Result<void> Success, ErrorCode::InvalidNumber for a non-finite
+     *         number, or ErrorCode::OutOfMemory if the sink lost output.
+     */
+    Result<void> write(const Node* root, Sink& out);
+
+private:
+    /// A container being written and the index of its next element.
+    struct Frame {
+        const Node* node;
+        size_t next;
+        size_t order;   ///< Start of an object's sorted members in order_
+    };
+
+    bool write_node(const Node* root, Sink& out);
+    bool write_scalar(const Node* node, Sink& out);
+
+    std::vector<Frame> stack_;              ///< Open containers
+    std::vector<const ObjectPair*> order_;  ///< Sorted members of open objects
+};
+
+/**
+ * @brief Serializes a tree in RFC 8785 canonical form.
+ *
+ * @param root The root node of the tree.
+ * @return Result<std::string> The canonical text, or an error.
+ */
+inline Result<std::string> write_canonical(const Node* root) {
+    CanonicalWriter writer;
+    return writer.write(root);
+}
+
+} // namespace json
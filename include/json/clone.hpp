@@ -0,0 +1,47 @@
+/**
+ * @file clone.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Deep copy of JSON trees
+ * 
+ * This file declares functions that copy an AST into a fresh arena as a
+ * single, tightly packed region.
+ * @version 1.0.0
+ * @date 2026-01-04
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#pragma once
+
+#include "ast.hpp"
+#include "arena.hpp"
+#include "error.hpp"
+
+namespace json {
+
+/**
+ * @brief Computes the exact number of bytes clone_compact() needs for a tree.
+ * 
+ * @param root The root node of the tree to measure.
+ * @return size_t Size in bytes of the packed copy (0 for a null root).
+ */
+[[nodiscard]] size_t compact_size(const Node* root);
+
+/**
+ * @brief Deep-copies a tree into one contiguous region of the destination arena.
+ * 
+ * The copy is laid out in a single allocation of compact_size(root) bytes:
+ * all nodes in breadth-first order (so siblings are adjacent), followed by
+ * the array element and object pair tables, followed by every string and
+ * key packed back to back. The source tree is not modified and may live in
+ * any arena, including the destination.
+ * 
+ * @param root The root node of the tree to copy.
+ * @param dst The arena that receives the copy.
+ * @return Result<Node*> The root of the copy, or ErrorCode::OutOfMemory if
+ *         the destination arena's budget cannot fit it.
+ */
+Result<Node*> clone_compact(const Node* root, Arena& dst);
+
+} // namespace json
@@ -0,0 +1,204 @@
+/**
+ * @file concurrent_arena.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Thread-safe Memory Arena API
+ * 
+ * This file defines a memory arena that many threads can allocate from at
+ * once, so parallel parsers and builders can produce a single document
+ * with a single lifetime owner.
+ * @version 1.0.0
+ * @date 2026-01-04
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace json {
+
+/**
+ * @brief A memory arena safe for concurrent allocation from many threads.
+ * 
+ * Every thread bumps a pointer in its own chunk, so allocation takes no
+ * locks and touches no shared cache lines. Atomics are only used when a
+ * thread needs a fresh chunk, which is pushed onto a lock-free list.
+ * Everything is freed at once when the ConcurrentArena is destroyed.
+ * 
+ * ConcurrentArena is also a `std::pmr::memory_resource`. Using it as the
+ * upstream of a per-thread Arena lets each worker parse with the regular
+ * single-threaded API while the blocks outlive the worker's Arena:
+ * 
+ * Example:
+ *   ConcurrentArena shared;
+ *   // On each worker thread:
+ *   Arena local(&shared);
+ *   auto result = parse(input, local);  // nodes stay valid after `local` dies
+ * 
+ * The upstream resource must itself be thread-safe. A thread that switches
+ * between several ConcurrentArenas abandons the rest of its current chunk
+ * on every switch.
+ */
+class ConcurrentArena final : public std::pmr::memory_resource {
+public:
+    /// Default size of per-thread chunks (256KB).
+    static constexpr size_t DefaultChunkSize = 256 * 1024;
+
+    /// Largest Arena block size served from per-thread chunks at the default
+    /// chunk size; larger requests each take a dedicated upstream chunk.
+    static constexpr size_t DefaultLocalBlockSize = DefaultChunkSize / 4 - alignof(std::max_align_t);
+
+    /**
+     * @brief Constructs a new ConcurrentArena.
+     * 
+     * @param chunk_size The size of each per-thread chunk in bytes. Defaults to 256KB.
+     * @param upstream The thread-safe resource chunks are obtained from.
+     */
+    explicit ConcurrentArena(size_t chunk_size = DefaultChunkSize,
+                             std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : chunk_size_(chunk_size), upstream_(upstream),
+          id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {}
+
+    /**
+     * @brief Destroys the arena and frees every chunk of every thread.
+     * 
+     * No thread may allocate from the arena while it is being destroyed.
+     */
+    ~ConcurrentArena() override {
+        ChunkHeader* chunk = head_.load(std::memory_order_acquire);
+        while (chunk) {
+            ChunkHeader* next = chunk->next;
+            upstream_->deallocate(chunk, chunk->size, ChunkAlignment);
+            chunk = next;
+        }
+    }
+
+    // Non-copyable, non-movable
+    ConcurrentArena(const ConcurrentArena&) = delete;
+    ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+
+    /**
+     * @brief Allocates memory for objects of type T from the calling thread's chunk.
+     * 
+     * @tparam T The type of object to allocate.
+     * @param count The number of objects to allocate. Defaults to 1.
+     * @return T* Pointer to the allocated memory.
+     */
+    template<typename T>
+    [[nodiscard]] T* alloc(size_t count = 1) {
+        return static_cast<T*>(bump(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Gets the number of bytes held from the upstream resource.
+     * 
+     * @return size_t Total size of all chunks.
+     */
+    [[nodiscard]] size_t reserved() const noexcept {
+        return reserved_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the upstream memory resource.
+     * 
+     * @return std::pmr::memory_resource* The resource chunks are obtained from.
+     */
+    [[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+    /**
+     * @brief Gets the number of chunks held.
+     * 
+     * @return size_t Number of chunks, including dedicated large ones.
+     */
+    [[nodiscard]] size_t chunks() const noexcept {
+        return chunks_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Alignment of every chunk requested from upstream.
+    static constexpr size_t ChunkAlignment = alignof(std::max_align_t);
+
+    /// Stored at the start of each chunk to link it into the free list.
+    struct alignas(std::max_align_t) ChunkHeader {
+        ChunkHeader* next;
+        size_t size;
+    };
+
+    /// The calling thread's current chunk (zero-initialized: owns nothing).
+    struct LocalChunk {
+        uint64_t owner;
+        uint8_t* current;
+        size_t remaining;
+    };
+
+    void* bump(size_t size, size_t alignment) {
+        LocalChunk& local = local_;
+        if (local.owner == id_) [[likely]] {
+            uintptr_t addr = reinterpret_cast<uintptr_t>(local.current);
+            uintptr_t aligned = (addr + alignment - 1) & ~(alignment - 1);
+            size_t padding = aligned - addr;
+            if (padding + size <= local.remaining) [[likely]] {
+                local.current += padding + size;
+                local.remaining -= padding + size;
+                return reinterpret_cast<void*>(aligned);
+            }
+        }
+        return refill(size, alignment);
+    }
+
+    void* refill(size_t size, size_t alignment) {
+        size_t align = alignment > ChunkAlignment ? alignment : ChunkAlignment;
+        if (size + align > chunk_size_ / 4) {
+            // Large allocation - dedicated chunk, keep the thread's current one
+            uint8_t* payload = new_chunk(sizeof(ChunkHeader) + size + align - ChunkAlignment);
+            uintptr_t addr = reinterpret_cast<uintptr_t>(payload);
+            return reinterpret_cast<void*>((addr + alignment - 1) & ~(alignment - 1));
+        }
+
+        LocalChunk& local = local_;
+        local.owner = id_;
+        local.current = new_chunk(chunk_size_);
+        local.remaining = chunk_size_ - sizeof(ChunkHeader);
+        return bump(size, alignment);
+    }
+
+    /// Obtains a chunk from upstream and publishes it; returns its payload.
+    uint8_t* new_chunk(size_t bytes) {
+        auto* chunk = static_cast<ChunkHeader*>(upstream_->allocate(bytes, ChunkAlignment));
+        chunk->size = bytes;
+        chunk->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(chunk->next, chunk,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+        reserved_.fetch_add(bytes, std::memory_order_relaxed);
+        chunks_.fetch_add(1, std::memory_order_relaxed);
+        return reinterpret_cast<uint8_t*>(chunk + 1);
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return bump(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    size_t chunk_size_;
+    std::pmr::memory_resource* upstream_;
+    uint64_t id_;   ///< Never reused, so stale thread caches cannot match a new arena
+    std::atomic<ChunkHeader*> head_{nullptr};
+    std::atomic<size_t> reserved_{0};
+    std::atomic<size_t> chunks_{0};
+
+    static inline std::atomic<uint64_t> next_id_{1};
+    static inline thread_local LocalChunk local_;
+};
+
+} // namespace json
@@ -0,0 +1,101 @@
+/**
+ * @file document.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Owning JSON Document API
+ * 
+ * This file defines the Document class, which bundles a parsed AST with
+ * the arena that owns its memory.
+ * @version 1.0.0
+ * @date 2026-01-04
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#pragma once
+
+#include "ast.hpp"
+#include "arena.hpp"
+#include "mapped_file.hpp"
+#include <span>
+#include <utility>
+
+namespace json {
+
+/**
+ * @brief A JSON tree together with the arena that owns it.
+ * 
+ * Moving a Document transfers ownership of the arena's blocks without
+ * copying or re-pointing any node, so documents can be handed between
+ * threads or pipeline stages by value. A document parsed from a file
+ * (see parse_document_file()) also owns the file mapping its strings
+ * point into.
+ * 
+ * Example:
+ *   auto doc = parse_document(R"({"id": 1})");
+ *   if (doc) queue.push_back(std::move(*doc));
+ */
+class Document {
+public:
+    /**
+     * @brief Takes ownership of an arena and a root node allocated in it.
+     * 
+     * @param arena The arena holding every node reachable from root.
+     * @param root The root node of the tree.
+     */
+    Document(Arena&& arena, Node* root) noexcept
+        : arena_(std::move(arena)), root_(root) {}
+
+    /**
+     * @brief Takes ownership of an arena, a root node and the input it references.
+     * 
+     * @param arena The arena holding every node reachable from root.
+     * @param root The root node of the tree.
+     * @param source The mapped input that string values may point into.
+     */
+    Document(Arena&& arena, Node* root, MappedFile&& source) noexcept
+        : source_(std::move(source)), arena_(std::move(arena)), root_(root) {}
+
+    Document(Document&& other) noexcept
+        : source_(std::move(other.source_)),
+          arena_(std::move(other.arena_)),
+          root_(std::exchange(other.root_, nullptr)) {}
+
+    Document& operator=(Document&& other) noexcept {
+        if (this != &other) {
+            source_ = std::move(other.source_);
+            arena_ = std::move(other.arena_);
+            root_ = std::exchange(other.root_, nullptr);
+        }
+        return *this;
+    }
+
+    // Non-copyable: use clone_compact() for an explicit deep copy
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    /// Gets the root node (nullptr for a moved-from document).
+    [[nodiscard]] Node* root() const noexcept { return root_; }
+
+    /// Gets the arena owning the tree, e.g. to build additional nodes.
+    [[nodiscard]] Arena& arena() noexcept { return arena_; }
+
+    /// Gets the arena owning the tree.
+    [[nodiscard]] const Arena& arena() const noexcept { return arena_; }
+
+    /// Gets the owned input text (empty unless parsed from a file).
+    [[nodiscard]] std::span<const char> source() const noexcept { return source_.data(); }
+
+    /// Accesses the root node.
+    const Node* operator->() const noexcept { return root_; }
+
+    /// Accesses the root node.
+    const Node& operator*() const noexcept { return *root_; }
+
+private:
+    MappedFile source_;
+    Arena arena_;
+    Node* root_;
+};
+
+} // namespace json
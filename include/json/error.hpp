@@ -35,7 +35,10 @@ enum class ErrorCode : uint8_t {
     ExpectedComma,      ///< Expected ',' between elements
     ExpectedValue,      ///< Expected a value (null, bool, number, string, array, object)
     TooDeep,            ///< Nesting depth exceeded limit
-    OutOfMemory         ///< Memory allocation failed
+    OutOfMemory,        ///< Memory allocation failed
+    Cancelled,          ///< Processing stopped by a user callback
+    TooLarge,           ///< Input or string longer than the configured limit
+    DuplicateKey        ///< Object key repeated where duplicates are rejected
 };
 
 /**
@@ -80,6 +83,9 @@ constexpr std::string_view error_message(ErrorCode code) {
         case ErrorCode::ExpectedValue: return "Expected value";
         case ErrorCode::TooDeep: return "Nesting too deep";
         case ErrorCode::OutOfMemory: return "Out of memory";
+        case ErrorCode::Cancelled: return "Cancelled";
+        case ErrorCode::TooLarge: return "Size limit exceeded";
+        case ErrorCode::DuplicateKey: return "Duplicate object key";
         default: return "Unknown error";
     }
 }
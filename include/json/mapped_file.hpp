@@ -0,0 +1,86 @@
+/**
+ * @file mapped_file.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Read-only File Mapping API
+ *
+ * This file defines MappedFile, which exposes a file's contents as memory
+ * so it can be parsed in place without copying it into an arena.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "error.hpp"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace json {
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped where supported.
+ *
+ * On POSIX systems the file is mapped with `MAP_PRIVATE` and the kernel is
+ * advised that it will be read sequentially and soon, so pages are read
+ * ahead and shared with the page cache instead of being copied. Elsewhere
+ * the contents are read into a heap buffer. Either way the bytes stay valid
+ * for the lifetime of the object; moving it does not move the bytes.
+ */
+class MappedFile {
+public:
+    /// Constructs an empty mapping.
+    MappedFile() noexcept = default;
+
+    ~MappedFile() { release(); }
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          buffer_(std::move(other.buffer_)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps a file for reading.
+     *
+     * @param filename Path to the file.
+     * @return Result<MappedFile> The mapping, or an error if the file cannot
+     *         be opened or mapped.
+     */
+    static Result<MappedFile> open(const char* filename);
+
+    /// Gets the file contents.
+    [[nodiscard]] std::span<const char> data() const noexcept { return {data_, size_}; }
+
+    /// Gets the file size in bytes.
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    /// Checks whether the contents are a memory mapping rather than a copy.
+    [[nodiscard]] bool mapped() const noexcept { return data_ && !buffer_; }
+
+private:
+    void release() noexcept;
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::unique_ptr<char[]> buffer_;    ///< Owned copy when mapping is unavailable
+};
+
+} // namespace json
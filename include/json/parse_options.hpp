@@ -0,0 +1,121 @@
+/**
+ * @file parse_options.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief JSON Parse Options
+ *
+ * This file defines the options accepted by the tokenizer, parser and
+ * validator, and the compile-time policies the tokenizer and parser are
+ * instantiated with.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace json {
+
+/**
+ * @brief How an object holding the same key more than once is treated.
+ */
+enum class DuplicateKeys : uint8_t {
+    Keep,       ///< Keep every member, in input order
+    Reject,     ///< Fail with ErrorCode::DuplicateKey
+    KeepLast    ///< Keep only the last member with each key
+};
+
+/**
+ * @brief Which numbers are accepted.
+ */
+enum class NumberMode : uint8_t {
+    Double,     ///< Any number within double range
+    Integer     ///< Only integers without fraction or exponent, exact in a double (|n| <= 2^53)
+};
+
+/**
+ * @brief Options controlling how input is parsed.
+ *
+ * The defaults accept any well-formed JSON, as parse() always has. The
+ * parser is compiled twice: once without the optional checks, used when
+ * depth, duplicate-key and number options keep their defaults, and once
+ * with them, so the default path pays nothing for checks it does not use.
+ */
+struct ParseOptions {
+    /// Value meaning "no limit" for the size options.
+    static constexpr size_t Unlimited = static_cast<size_t>(-1);
+
+    /// Default (and highest) nesting depth.
+    static constexpr size_t DefaultMaxDepth = 256;
+
+    /// Maximum nesting depth; values above DefaultMaxDepth act as DefaultMaxDepth,
+    /// which bounds the recursive parser's stack use.
+    size_t max_depth = DefaultMaxDepth;
+
+    /// Maximum input size in bytes.
+    size_t max_document_size = Unlimited;
+
+    /// Maximum length in bytes of a string or key after unescaping.
+    size_t max_string_length = Unlimited;
+
+    /// Treatment of repeated object keys.
+    DuplicateKeys duplicate_keys = DuplicateKeys::Keep;
+
+    /// Require string contents to be well-formed UTF-8 without raw control
+    /// characters, as RFC 8259 demands. Checked while strings are scanned;
+    /// pure ASCII runs are skipped a vector at a time.
+    bool validate_utf8 = false;
+
+    /// Which numbers are accepted.
+    NumberMode number_mode = NumberMode::Double;
+
+    /// Tokenize ahead into blocks of TokenBlock::Capacity compact tokens
+    /// instead of fetching one token at a time. Changes only how tokens
+    /// reach the parser, so every policy honors it.
+    bool buffer_tokens = false;
+
+    /// Checks whether the structural checks (depth, duplicate keys, number
+    /// mode) all keep their defaults.
+    [[nodiscard]] constexpr bool structural_defaults() const noexcept {
+        return max_depth >= DefaultMaxDepth && duplicate_keys == DuplicateKeys::Keep &&
+               number_mode == NumberMode::Double;
+    }
+};
+
+/**
+ * @brief Compile-time configuration of BasicTokenizer and BasicParser.
+ *
+ * With `RuntimeOptions` every check is read from ParseOptions while
+ * parsing. Without it ParseOptions other than buffer_tokens are ignored:
+ * the engine is specialized for the policy's UTF-8 and number settings,
+ * with the default depth limit and no size limits or duplicate-key
+ * handling, so none of those checks are compiled in.
+ *
+ * @tparam RuntimeOptions Read the checks from ParseOptions at runtime.
+ * @tparam ValidateUtf8 Check string contents (fixed policies only).
+ * @tparam Numbers Accepted numbers (fixed policies only).
+ */
+template <bool RuntimeOptions, bool ValidateUtf8 = false, NumberMode Numbers = NumberMode::Double>
+struct ParsePolicy {
+    static constexpr bool runtime_options = RuntimeOptions;
+    static constexpr bool validate_utf8 = ValidateUtf8;
+    static constexpr NumberMode number_mode = Numbers;
+};
+
+/// Checks chosen at runtime through ParseOptions (Tokenizer, Parser).
+using DefaultPolicy = ParsePolicy<true>;
+
+/// Trusted input: the JSON grammar and nothing else.
+using TrustedPolicy = ParsePolicy<false>;
+
+/// Untrusted text: strings must be well-formed UTF-8 without raw control characters.
+using StrictPolicy = ParsePolicy<false, true>;
+
+/// Trusted input whose numbers are all exact integers.
+using TrustedIntegerPolicy = ParsePolicy<false, false, NumberMode::Integer>;
+
+} // namespace json
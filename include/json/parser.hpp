@@ -18,6 +18,10 @@
 #include "arena.hpp"
 #include "tokenizer.hpp"
 #include "error.hpp"
+#include "parse_options.hpp"
+#include <memory>
+#include <memory_resource>
+#include <vector>
 
 namespace json {
 
@@ -27,17 +31,38 @@ namespace json {
  * The Parser class consumes tokens from a Tokenizer and constructs a
  * hierarchical Abstract Syntax Tree (AST) stored in the provided Arena.
  * It enforces strict JSON syntax and handles recursion depth limits.
+ * 
+ * The checks selected by ParseOptions are compiled into a separate
+ * instantiation of the parsing routines; parse() picks it only when the
+ * options ask for them, so the default path carries none of them.
+ * Policies that do not read options at runtime (see ParsePolicy) compile
+ * only the checks they name. The parser is instantiated for the same
+ * policies as BasicTokenizer.
+ * 
+ * @tparam Policy A ParsePolicy instantiation, shared with the tokenizer.
  */
-class Parser {
+template <typename Policy>
+class BasicParser {
 public:
     /**
      * @brief Constructs a new Parser object.
      * 
      * @param arena The memory arena used for allocating AST nodes.
-     * @param tokenizer The source of JSON tokens.
+     * @param tokenizer The source of JSON tokens; string options (UTF-8,
+     *                  string length) are given to it directly.
+     * @param options Limits and policies for the document structure; ignored
+     *                unless the policy reads options at runtime.
+     * @param scratch Resource for the parser's scratch buffers, which are
+     *                freed as they grow; null uses the arena's upstream.
      */
-    Parser(Arena& arena, Tokenizer& tokenizer)
-        : arena_(arena), tok_(tokenizer), depth_(0) {}
+    BasicParser(Arena& arena, BasicTokenizer<Policy>& tokenizer, const ParseOptions& options = {},
+                std::pmr::memory_resource* scratch = nullptr)
+        : arena_(arena), tok_(&tokenizer), depth_(0), options_(options),
+          checked_(!options.structural_defaults()),
+          scratch_(scratch ? scratch : arena.upstream()),
+          block_(options.buffer_tokens ? make_block(scratch_) : nullptr, BlockDeleter{scratch_}),
+          elements_(scratch_), pairs_(scratch_),
+          key_offsets_(scratch_), order_(scratch_) {}
 
     /**
      * @brief Parses the entire JSON input into an AST.
@@ -49,23 +74,72 @@ public:
      */
     Result<Node*> parse();
 
+    /**
+     * @brief Parses the input of another tokenizer into the same arena.
+     * 
+     * Reusing one parser for many documents keeps its scratch buffers, so
+     * after the first few documents no setup allocations are made.
+     * 
+     * @param tokenizer The source of JSON tokens for the next document.
+     * @return Result<Node*> The root node of the generated AST, or an error if parsing fails.
+     */
+    Result<Node*> parse(BasicTokenizer<Policy>& tokenizer);
+
 private:
+    /// Returns a TokenBlock to the resource it was allocated from.
+    struct BlockDeleter {
+        std::pmr::memory_resource* resource;
+        void operator()(TokenBlock* block) const {
+            std::pmr::polymorphic_allocator<TokenBlock>(resource).delete_object(block);
+        }
+    };
+
+    static TokenBlock* make_block(std::pmr::memory_resource* resource) {
+        return std::pmr::polymorphic_allocator<TokenBlock>(resource).new_object<TokenBlock>(resource);
+    }
+
     /// Maximum allowed recursion depth to prevent stack overflow.
     static constexpr size_t MaxDepth = 256;
 
-    Result<Node*> parse_value();
-    Result<Node*> parse_object();
-    Result<Node*> parse_array();
+    /// A fixed integer policy converts numbers as integers only.
+    static constexpr bool IntegersOnly =
+        !Policy::runtime_options && Policy::number_mode == NumberMode::Integer;
+
+    template <bool Checked> Result<Node*> parse_root();
+    template <bool Checked> Result<Node*> parse_value();
+    template <bool Checked> Result<Node*> parse_object();
+    template <bool Checked> Result<Node*> parse_array();
+    Result<double> read_integer(const Token& token) const;
+    Result<void> apply_duplicate_policy(size_t base);
     
-    Result<Token> expect(TokenType type);
-    Result<Token> peek();
+    Result<void> expect(TokenType type);
+    const Token& peek();
     void consume();
+    Result<Node*> new_node(const Node& value, size_t offset);
 
     Arena& arena_;
-    Tokenizer& tok_;
+    BasicTokenizer<Policy>* tok_;
     Token current_;
     bool has_current_ = false;
+    Error error_{ErrorCode::None, 0, {}};   ///< Tokenizer error behind an Invalid token (unbuffered)
+    size_t cursor_ = 0;                     ///< Next token in block_
     size_t depth_;
+    ParseOptions options_;
+    bool checked_;                          ///< Use the instantiation with optional checks
+    std::pmr::memory_resource* scratch_;    ///< Backs the scratch buffers below
+    std::unique_ptr<TokenBlock, BlockDeleter> block_;   ///< Tokens read ahead (buffer_tokens only)
+    std::pmr::vector<Node*> elements_;      ///< Elements of all open arrays, innermost last
+    std::pmr::vector<ObjectPair> pairs_;    ///< Members of all open objects, innermost last
+    std::pmr::vector<size_t> key_offsets_;  ///< Key offsets parallel to pairs_ (checked mode)
+    std::pmr::vector<size_t> order_;        ///< Scratch for sorting an object's keys
 };
 
+/// Parser configured at runtime through ParseOptions.
+using Parser = BasicParser<DefaultPolicy>;
+
+extern template class BasicParser<DefaultPolicy>;
+extern template class BasicParser<TrustedPolicy>;
+extern template class BasicParser<StrictPolicy>;
+extern template class BasicParser<TrustedIntegerPolicy>;
+
 } // namespace json
@@ -0,0 +1,404 @@
+/**
+ * @file sink.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief JSON Output Sink API
+ * 
+ * This file defines the buffered output abstraction the Writer serializes
+ * into, together with sinks for strings, caller buffers, arenas, output
+ * iterators, stdio streams, file descriptors and user callbacks.
+ * @version 1.0.0
+ * @date 2026-01-04
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#pragma once
+
+#include "arena.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+/**
+ * @brief Destination for serialized JSON text.
+ * 
+ * A Sink exposes a window of writable memory. Writes bump a pointer inside
+ * that window; only when it is full does the sink call overflow() to hand
+ * the bytes on (or grow) and provide a fresh window. Once a sink fails
+ * (e.g. a write error), further output is discarded and failed() is true.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * @brief Writes a single character.
+     * 
+     * @param c The character to write.
+     */
+    void put(char c) {
+        if (cur_ == end_ && !overflow(1)) [[unlikely]] return;
+        *cur_++ = c;
+    }
+
+    /**
+     * @brief Writes a run of characters.
+     * 
+     * @param data Pointer to the characters.
+     * @param size Number of characters.
+     */
+    void append(const char* data, size_t size) {
+        if (size <= static_cast<size_t>(end_ - cur_)) [[likely]] {
+            if (size) std::memcpy(cur_, data, size);
+            cur_ += size;
+            return;
+        }
+        append_slow(data, size);
+    }
+
+    /// Writes a string view.
+    void append(std::string_view str) { append(str.data(), str.size()); }
+
+    /**
+     * @brief Writes a character repeated `count` times.
+     * 
+     * @param c The character to write.
+     * @param count Number of repetitions.
+     */
+    void fill(char c, size_t count);
+
+    /// Gets the number of bytes that can be written without overflowing.
+    [[nodiscard]] size_t available() const { return static_cast<size_t>(end_ - cur_); }
+
+    /**
+     * @brief Provides direct access to at least `size` contiguous bytes.
+     * 
+     * Write into the returned memory, then call commit() with one past the
+     * last byte written. Intended for small, bounded writes (`size` up to 64).
+     * 
+     * @param size Number of bytes needed.
+     * @return char* Pointer to writable memory, or nullptr if the sink failed.
+     */
+    [[nodiscard]] char* reserve(size_t size) {
+        if (size > static_cast<size_t>(end_ - cur_)) [[unlikely]] {
+            if (!overflow(size) || size > static_cast<size_t>(end_ - cur_)) {
+                failed_ = true;
+                return nullptr;
+            }
+        }
+        return cur_;
+    }
+
+    /**
+     * @brief Completes a write started with reserve().
+     * 
+     * @param end One past the last byte written into the reserved memory.
+     */
+    void commit(char* end) { cur_ = end; }
+
+    /**
+     * @brief Hands all buffered output to the destination.
+     * 
+     * @return true If every byte written so far reached the destination.
+     */
+    bool flush() { return sync() && !failed_; }
+
+    /// Checks whether output has been lost.
+    [[nodiscard]] bool failed() const { return failed_; }
+
+protected:
+    /**
+     * @brief Makes room after the window is full.
+     * 
+     * Implementations deliver or keep the bytes in [window start, cur_) and
+     * set a new window. At least `size` bytes must become available when the
+     * sink's capacity allows it, and at least one byte otherwise.
+     * 
+     * @param size Number of bytes the caller wants to write.
+     * @return false If the sink failed; it must then set failed_.
+     */
+    virtual bool overflow(size_t size) = 0;
+
+    /// Delivers buffered bytes to the destination. Defaults to a no-op.
+    virtual bool sync() { return true; }
+
+    char* cur_ = nullptr;   ///< Next byte to write
+    char* end_ = nullptr;   ///< End of the writable window
+    bool failed_ = false;   ///< Set once output has been lost
+
+private:
+    void append_slow(const char* data, size_t size);
+};
+
+/**
+ * @brief Sink appending to a std::string, growing it geometrically.
+ * 
+ * While the sink is active the string may hold unused bytes at its end;
+ * call flush() (or destroy the sink) to trim it to the written size.
+ */
+class StringSink final : public Sink {
+public:
+    /**
+     * @brief Constructs a sink that appends to `out`.
+     * 
+     * @param out The string to append to. Existing contents are kept.
+     */
+    explicit StringSink(std::string& out) : out_(out), size_(out.size()) {}
+
+    ~StringSink() override { sync(); }
+
+    StringSink(const StringSink&) = delete;
+    StringSink& operator=(const StringSink&) = delete;
+
+protected:
+    bool overflow(size_t size) override;
+    bool sync() override;
+
+private:
+    std::string& out_;
+    size_t size_;   ///< Length of the string once trimmed
+};
+
+/**
+ * @brief Sink with a fixed-size buffer that is handed downstream when full.
+ * 
+ * Memory use stays constant regardless of output size, and output is
+ * delivered while serialization is still running.
+ */
+class BufferedSink : public Sink {
+public:
+    /// Default buffer capacity (64KB).
+    static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+    /// Smallest accepted buffer capacity.
+    static constexpr size_t MinBufferSize = 64;
+
+    /**
+     * @brief Constructs a sink with an owned buffer.
+     * 
+     * @param buffer_size The buffer capacity in bytes (at least MinBufferSize).
+     */
+    explicit BufferedSink(size_t buffer_size = DefaultBufferSize);
+
+    BufferedSink(const BufferedSink&) = delete;
+    BufferedSink& operator=(const BufferedSink&) = delete;
+
+protected:
+    /**
+     * @brief Delivers a run of bytes to the destination.
+     * 
+     * @return false If the destination could not take them.
+     */
+    virtual bool deliver(const char* data, size_t size) = 0;
+
+    bool overflow(size_t size) override;
+    bool sync() override;
+
+private:
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+};
+
+/**
+ * @brief Buffered sink writing to a stdio stream.
+ */
+class FileSink final : public BufferedSink {
+public:
+    /**
+     * @brief Constructs a sink writing to `file`.
+     * 
+     * @param file The stream to write to (not closed by the sink).
+     * @param buffer_size The buffer capacity in bytes.
+     */
+    explicit FileSink(FILE* file, size_t buffer_size = DefaultBufferSize)
+        : BufferedSink(buffer_size), file_(file) {}
+
+    ~FileSink() override { sync(); }
+
+protected:
+    bool deliver(const char* data, size_t size) override;
+
+private:
+    FILE* file_;
+};
+
+/**
+ * @brief Buffered sink writing to a file descriptor.
+ */
+class FdSink final : public BufferedSink {
+public:
+    /**
+     * @brief Constructs a sink writing to `fd`.
+     * 
+     * @param fd The descriptor to write to (not closed by the sink).
+     * @param buffer_size The buffer capacity in bytes.
+     */
+    explicit FdSink(int fd, size_t buffer_size = DefaultBufferSize)
+        : BufferedSink(buffer_size), fd_(fd) {}
+
+    ~FdSink() override { sync(); }
+
+protected:
+    bool deliver(const char* data, size_t size) override;
+
+private:
+    int fd_;
+};
+
+/**
+ * @brief Buffered sink handing each full buffer to a user callback.
+ * 
+ * The callback returns false to abort serialization.
+ */
+class CallbackSink final : public BufferedSink {
+public:
+    /// Callback receiving a run of output bytes.
+    using Callback = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * @brief Constructs a sink calling `callback` with buffered output.
+     * 
+     * @param callback The function receiving output.
+     * @param buffer_size The buffer capacity in bytes.
+     */
+    explicit CallbackSink(Callback callback, size_t buffer_size = DefaultBufferSize)
+        : BufferedSink(buffer_size), callback_(std::move(callback)) {}
+
+    ~CallbackSink() override { sync(); }
+
+protected:
+    bool deliver(const char* data, size_t size) override {
+        return callback_(data, size);
+    }
+
+private:
+    Callback callback_;
+};
+
+/**
+ * @brief Writes a list of buffers to a file descriptor in order.
+ * 
+ * Uses `writev` gather writes where available, so pieces produced
+ * separately (e.g. by Writer::write_chunks()) need not be joined first.
+ * 
+ * @param fd The descriptor to write to (not closed).
+ * @param pieces The buffers to write.
+ * @return true If every byte was written.
+ */
+bool write_gather(int fd, std::span<const std::string> pieces);
+
+/**
+ * @brief Sink writing into a fixed, caller-owned buffer.
+ * 
+ * The sink fails once the buffer is full; the bytes written up to that
+ * point remain in the buffer.
+ */
+class SpanSink final : public Sink {
+public:
+    /**
+     * @brief Constructs a sink over `buffer`.
+     * 
+     * @param buffer The memory to write into.
+     */
+    explicit SpanSink(std::span<char> buffer) : begin_(buffer.data()) {
+        cur_ = buffer.data();
+        end_ = buffer.data() + buffer.size();
+    }
+
+    /// Gets the number of bytes written so far.
+    [[nodiscard]] size_t size() const { return static_cast<size_t>(cur_ - begin_); }
+
+protected:
+    bool overflow(size_t) override {
+        failed_ = true;
+        return false;
+    }
+
+private:
+    char* begin_;
+};
+
+/**
+ * @brief Sink writing into memory obtained from an Arena.
+ * 
+ * The output lives in one contiguous arena region that is replaced by a
+ * region twice the size when full. Earlier regions are only reclaimed
+ * with the arena, so give the sink a capacity hint when the size is known
+ * (e.g. from json::measure()). The sink fails once the arena's budget is
+ * exhausted.
+ */
+class ArenaSink final : public Sink {
+public:
+    /**
+     * @brief Constructs a sink allocating from `arena`.
+     * 
+     * @param arena The arena providing the output memory.
+     * @param capacity Initial capacity in bytes.
+     */
+    explicit ArenaSink(Arena& arena, size_t capacity = 256);
+
+    ArenaSink(const ArenaSink&) = delete;
+    ArenaSink& operator=(const ArenaSink&) = delete;
+
+    /// Gets the output written so far. Valid until the next write.
+    [[nodiscard]] std::string_view view() const {
+        return {begin_, static_cast<size_t>(cur_ - begin_)};
+    }
+
+protected:
+    bool overflow(size_t size) override;
+
+private:
+    Arena& arena_;
+    char* begin_ = nullptr;
+};
+
+/**
+ * @brief Buffered sink copying output through an output iterator.
+ * 
+ * Bytes are batched in a small buffer and copied to the iterator when it
+ * is full or the sink is flushed.
+ * 
+ * @tparam OutputIt An output iterator accepting `char`.
+ */
+template<std::output_iterator<char> OutputIt>
+class IteratorSink final : public BufferedSink {
+public:
+    /// Default buffer capacity (4KB).
+    static constexpr size_t DefaultIteratorBufferSize = 4 * 1024;
+
+    /**
+     * @brief Constructs a sink writing through `out`.
+     * 
+     * @param out The iterator receiving the output.
+     * @param buffer_size The buffer capacity in bytes.
+     */
+    explicit IteratorSink(OutputIt out, size_t buffer_size = DefaultIteratorBufferSize)
+        : BufferedSink(buffer_size), out_(std::move(out)) {}
+
+    ~IteratorSink() override { sync(); }
+
+    /// Gets the iterator one past the last byte delivered.
+    [[nodiscard]] OutputIt iterator() const { return out_; }
+
+protected:
+    bool deliver(const char* data, size_t size) override {
+        out_ = std::copy(data, data + size, std::move(out_));
+        return true;
+    }
+
+private:
+    OutputIt out_;
+};
+
+} // namespace json
@@ -0,0 +1,261 @@
+/**
+ * @file stream_parser.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief JSON Streaming Parser API
+ *
+ * This file defines a resumable, event-based parser that consumes input in
+ * chunks of any size, together with drivers for streams and descriptors.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "ast.hpp"
+#include "arena.hpp"
+#include "error.hpp"
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+/**
+ * @brief Receives the values found by a StreamParser.
+ *
+ * Strings and keys are passed with escapes already decoded. The views are
+ * only valid during the call; copy them to keep them. Every callback
+ * returns false to stop parsing, which makes the parser report
+ * ErrorCode::Cancelled. The default implementations ignore the event.
+ */
+class EventHandler {
+public:
+    virtual ~EventHandler() = default;
+
+    virtual bool on_null() { return true; }
+    virtual bool on_bool(bool) { return true; }
+    virtual bool on_number(double) { return true; }
+    virtual bool on_string(std::string_view) { return true; }
+    virtual bool on_key(std::string_view) { return true; }
+    virtual bool on_begin_object() { return true; }
+    virtual bool on_end_object() { return true; }
+    virtual bool on_begin_array() { return true; }
+    virtual bool on_end_array() { return true; }
+
+    /// Called after each complete top-level value.
+    virtual bool on_document_end() { return true; }
+};
+
+/**
+ * @brief Resumable push parser producing events.
+ *
+ * Input is handed over with feed() in chunks split at arbitrary byte
+ * positions; tokens spanning chunks are carried over in an internal
+ * buffer, so memory use is bounded by the largest string or number plus
+ * the nesting depth, not by the input size. Strings that lie within one
+ * chunk and contain no escapes are reported without copying.
+ *
+ * In multi-document mode the input may hold any number of whitespace-
+ * separated top-level values, e.g. NDJSON; on_document_end() marks the
+ * end of each.
+ *
+ * Example:
+ *   StreamParser parser(handler);
+ *   while (size_t n = read_some(buffer)) {
+ *       if (auto ok = parser.feed({buffer, n}); !ok) return ok.error();
+ *   }
+ *   return parser.finish();
+ */
+class StreamParser {
+public:
+    /// Maximum nesting depth, matching the DOM parser's limit.
+    static constexpr size_t MaxDepth = 256;
+
+    /**
+     * @brief Constructs a parser delivering events to `handler`.
+     *
+     * @param handler The event receiver. Must outlive the parser.
+     * @param multiple_documents Accept a sequence of top-level values.
+     */
+    explicit StreamParser(EventHandler& handler, bool multiple_documents = false)
+        : handler_(handler), multiple_(multiple_documents) {}
+
+    /**
+     * @brief Parses the next chunk of input.
+     *
+     * @param chunk The bytes following those of the previous call.
+     * @return Result<void> Success, or the first error. After an error every
+     *         further call returns the same error.
+     */
+    Result<void> feed(std::span<const char> chunk);
+
+    /// Parses the next chunk of input from a string view.
+    Result<void> feed(std::string_view chunk) { return feed(std::span{chunk.data(), chunk.size()}); }
+
+    /**
+     * @brief Signals the end of input.
+     *
+     * Completes a trailing top-level number and checks that the input held
+     * one complete value (or, in multi-document mode, only complete values).
+     *
+     * @return Result<void> Success, or ErrorCode::UnexpectedEOF / the earlier error.
+     */
+    Result<void> finish();
+
+    /// Prepares the parser for a new input.
+    void reset();
+
+    /// Gets the number of bytes consumed so far.
+    [[nodiscard]] size_t offset() const noexcept { return offset_; }
+
+    /// Gets the number of complete top-level values parsed so far.
+    [[nodiscard]] size_t documents() const noexcept { return documents_; }
+
+private:
+    enum class State : uint8_t {
+        Value,          ///< Expecting a value
+        FirstValue,     ///< After '[': a value or ']'
+        FirstKey,       ///< After '{': a key or '}'
+        Key,            ///< After ',' in an object
+        Colon,          ///< After a key
+        CommaOrEnd,     ///< After an element
+        AfterRoot,      ///< A top-level value is complete
+        String,         ///< Inside a string or key
+        Number,         ///< Inside a number
+        Literal         ///< Inside true, false or null
+    };
+
+    enum class Escape : uint8_t {
+        None,           ///< Plain characters
+        Backslash,      ///< After '\'
+        Hex,            ///< Inside the four digits of \uXXXX
+        LowBackslash,   ///< After a high surrogate, expecting '\'
+        LowU            ///< After a high surrogate and '\', expecting 'u'
+    };
+
+    Result<size_t> parse_string(const char* data, size_t pos, size_t size);
+    Result<void> parse_escape(char c, size_t offset);
+    Result<void> parse_number(std::string_view text);
+    Result<void> begin_value(char c, size_t offset);
+    Result<void> complete_value();
+    Result<void> close(bool object, size_t offset);
+    Result<void> fail(ErrorCode code, size_t offset, std::string_view message = {});
+
+    EventHandler& handler_;
+    bool multiple_;
+    State state_ = State::Value;
+    Escape escape_ = Escape::None;
+    bool in_key_ = false;           ///< The current string is an object key
+    bool direct_ = false;           ///< The current string can be reported from the chunk
+    size_t depth_ = 0;
+    size_t offset_ = 0;             ///< Absolute offset of the current chunk
+    size_t token_start_ = 0;        ///< Absolute offset where the current token began
+    size_t documents_ = 0;
+    uint32_t hex_value_ = 0;
+    uint32_t hex_digits_ = 0;
+    uint32_t high_surrogate_ = 0;
+    std::string_view literal_;      ///< Text of the literal being matched
+    size_t literal_pos_ = 0;
+    std::string token_;             ///< Carried-over token bytes
+    std::array<bool, MaxDepth> objects_{};  ///< Whether each open container is an object
+    ErrorCode error_ = ErrorCode::None;
+    size_t error_offset_ = 0;
+    std::string_view error_message_;
+};
+
+/**
+ * @brief Event handler that builds a Node tree in an arena.
+ *
+ * String contents are copied into the arena, since the parser's views are
+ * transient. Use it with StreamParser to build a tree from input that is
+ * never held in memory as a whole.
+ */
+class DomBuilder final : public EventHandler {
+public:
+    /**
+     * @brief Constructs a builder allocating from `arena`.
+     *
+     * @param arena The arena receiving nodes and strings.
+     */
+    explicit DomBuilder(Arena& arena)
+        : arena_(arena), frames_(arena.upstream()), values_(arena.upstream()), keys_(arena.upstream()) {}
+
+    /// Gets the root of the last complete document (nullptr if none).
+    [[nodiscard]] Node* root() const noexcept { return root_; }
+
+    /// Checks whether building stopped because the arena's budget ran out.
+    [[nodiscard]] bool out_of_memory() const noexcept { return out_of_memory_; }
+
+    bool on_null() override { return add(Node::make_null()); }
+    bool on_bool(bool value) override { return add(Node::make_bool(value)); }
+    bool on_number(double value) override { return add(Node::make_number(value)); }
+    bool on_string(std::string_view str) override;
+    bool on_key(std::string_view key) override;
+    bool on_begin_object() override;
+    bool on_end_object() override;
+    bool on_begin_array() override;
+    bool on_end_array() override;
+
+private:
+    struct Frame {
+        size_t values;  ///< Index of the container's first element in values_
+        size_t keys;    ///< Index of the object's first key in keys_
+    };
+
+    bool add(const Node& node);
+    bool copy(std::string_view str, StringView& out);
+
+    Arena& arena_;
+    std::pmr::vector<Frame> frames_;
+    std::pmr::vector<Node*> values_;    ///< Elements of all open containers
+    std::pmr::vector<StringView> keys_; ///< Keys of all open objects
+    Node* root_ = nullptr;
+    bool out_of_memory_ = false;
+};
+
+/// Default size of the chunks read by the stream drivers (64KB).
+inline constexpr size_t DefaultChunkSize = 64 * 1024;
+
+/**
+ * @brief Parses a stream in fixed-size chunks, delivering events.
+ *
+ * @param in The stream to read until its end.
+ * @param handler The event receiver.
+ * @param multiple_documents Accept a sequence of top-level values (NDJSON).
+ * @param chunk_size Size of the read buffer in bytes.
+ * @return Result<void> Success, or the first error.
+ */
+Result<void> parse_stream(std::istream& in, EventHandler& handler,
+                          bool multiple_documents = false, size_t chunk_size = DefaultChunkSize);
+
+/**
+ * @brief Parses a file descriptor in fixed-size chunks, delivering events.
+ *
+ * @param fd The descriptor to read until end of file (not closed).
+ * @param handler The event receiver.
+ * @param multiple_documents Accept a sequence of top-level values (NDJSON).
+ * @param chunk_size Size of the read buffer in bytes.
+ * @return Result<void> Success, or the first error.
+ */
+Result<void> parse_stream(int fd, EventHandler& handler,
+                          bool multiple_documents = false, size_t chunk_size = DefaultChunkSize);
+
+/**
+ * @brief Parses a stream into a tree without reading it into memory first.
+ *
+ * @param in The stream to read until its end.
+ * @param arena The arena receiving nodes and string contents.
+ * @param chunk_size Size of the read buffer in bytes.
+ * @return Result<Node*> The root node, or an error.
+ */
+Result<Node*> parse_stream(std::istream& in, Arena& arena, size_t chunk_size = DefaultChunkSize);
+
+} // namespace json
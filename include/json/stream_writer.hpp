@@ -0,0 +1,157 @@
+/**
+ * @file stream_writer.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief JSON Streaming Writer API
+ *
+ * This file defines an emitter that writes JSON text event by event,
+ * without building a Node tree first.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "error.hpp"
+#include "sink.hpp"
+#include "writer.hpp"
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+
+namespace json {
+
+/**
+ * @brief Emits JSON text directly into a sink.
+ *
+ * Values, keys and container boundaries are written as they are called,
+ * using the same escaping and number formatting as Writer, so the output
+ * matches what Writer produces for the equivalent tree. Commas, colons and
+ * pretty-print indentation are inserted automatically.
+ *
+ * Calls that would produce invalid JSON (a value where a key is expected,
+ * mismatched end calls, a second root value, ...) write nothing and put
+ * the writer into a failed state; finish() reports the first such error.
+ * The error offset is the zero-based index of the offending call.
+ *
+ * Example:
+ *   StringSink sink(text);
+ *   StreamWriter w(sink);
+ *   w.begin_object().key("id").value(42).key("tags").begin_array()
+ *    .value("a").end_array().end_object();
+ *   if (!w.finish()) { ... }
+ */
+class StreamWriter {
+public:
+    /// Maximum nesting depth, matching the parser's limit.
+    static constexpr size_t MaxDepth = 256;
+
+    /**
+     * @brief Constructs a writer emitting into `out`.
+     *
+     * @param out The sink receiving the text. Must outlive the writer.
+     * @param options Formatting options.
+     */
+    explicit StreamWriter(Sink& out, const WriterOptions& options = {})
+        : out_(out), pretty_(options.pretty), indent_size_(options.indent_size) {}
+
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+
+    /// Opens an object.
+    StreamWriter& begin_object();
+
+    /// Closes the innermost object.
+    StreamWriter& end_object();
+
+    /// Opens an array.
+    StreamWriter& begin_array();
+
+    /// Closes the innermost array.
+    StreamWriter& end_array();
+
+    /**
+     * @brief Writes an object key; the next call must write its value.
+     *
+     * @param name The key, escaped as needed.
+     * @return StreamWriter& Reference to self for chaining.
+     */
+    StreamWriter& key(std::string_view name);
+
+    /// Writes `null`.
+    StreamWriter& value(std::nullptr_t);
+
+    /// Writes `true` or `false`.
+    StreamWriter& value(bool flag);
+
+    /// Writes a number (non-finite values are written as `null`).
+    StreamWriter& value(double number);
+
+    /// Writes a string literal.
+    StreamWriter& value(std::string_view str);
+
+    /// Writes a string literal from a null-terminated string.
+    StreamWriter& value(const char* str) { return value(std::string_view(str)); }
+
+    /**
+     * @brief Writes an integer exactly, including values beyond 2^53.
+     *
+     * @param number The integer to write.
+     * @return StreamWriter& Reference to self for chaining.
+     */
+    template<std::integral T>
+        requires (!std::same_as<T, bool> && !std::same_as<T, char>)
+    StreamWriter& value(T number) {
+        if constexpr (std::signed_integral<T>) {
+            return write_int(static_cast<int64_t>(number));
+        } else {
+            return write_uint(static_cast<uint64_t>(number));
+        }
+    }
+
+    /**
+     * @brief Checks that one complete value was written and flushes the sink.
+     *
+     * @return Result<void> Success, or the first error (ErrorCode::UnexpectedEOF
+     *         for unclosed containers or a missing root, ErrorCode::OutOfMemory
+     *         when the sink lost output).
+     */
+    [[nodiscard]] Result<void> finish();
+
+    /// Checks whether a call has been rejected or the sink failed.
+    [[nodiscard]] bool failed() const { return error_ != ErrorCode::None || out_.failed(); }
+
+    /// Gets the current nesting depth.
+    [[nodiscard]] size_t depth() const { return depth_; }
+
+private:
+    enum Frame : uint8_t {
+        InArray = 0,
+        InObject = 1,
+        HasElements = 2,    ///< At least one element has been written
+    };
+
+    bool before_value();
+    bool open(uint8_t kind, char bracket);
+    bool close(uint8_t kind, char bracket);
+    void newline_indent(size_t depth);
+    bool fail(ErrorCode code);
+    StreamWriter& write_int(int64_t number);
+    StreamWriter& write_uint(uint64_t number);
+
+    Sink& out_;
+    bool pretty_;
+    int indent_size_;
+    bool key_written_ = false;      ///< A key awaits its value
+    bool root_written_ = false;     ///< A complete root value has been written
+    size_t depth_ = 0;
+    size_t calls_ = 0;
+    ErrorCode error_ = ErrorCode::None;
+    size_t error_call_ = 0;
+    std::array<uint8_t, MaxDepth> frames_{};
+};
+
+} // namespace json
@@ -15,9 +15,13 @@
 #pragma once
 
 #include "error.hpp"
+#include "parse_options.hpp"
+#include <array>
+#include <memory_resource>
 #include <span>
 #include <string_view>
 #include <cstdint>
+#include <vector>
 
 namespace json {
 
@@ -38,7 +42,8 @@ enum class TokenType : uint8_t {
     Number,         ///< Number literal
     True,           ///< 'true' keyword
     False,          ///< 'false' keyword
-    Null            ///< 'null' keyword
+    Null,           ///< 'null' keyword
+    Invalid         ///< Where tokenizing failed; never returned by next()
 };
 
 /**
@@ -48,6 +53,66 @@ struct Token {
     TokenType type;         ///< The type of the token
     std::string_view text;  ///< The text content of the token
     size_t offset;          ///< The byte offset of the token in the input
+    bool verbatim = false;  ///< String whose content needs no escaping when written
+};
+
+/**
+ * @brief Compact form of a Token stored in a TokenBlock.
+ * 
+ * The text of most tokens is a range of the input and is rebuilt from the
+ * offset and length. Strings whose text lives elsewhere (unescaped into the
+ * arena) are kept in the block's side table instead.
+ */
+struct PackedToken {
+    static constexpr uint8_t Verbatim = 1 << 0;    ///< Token::verbatim
+    static constexpr uint8_t Side = 1 << 1;        ///< Text is TokenBlock::strings[data]
+
+    uint32_t data;          ///< Text length, or side table index with Side
+    TokenType type;         ///< The type of the token
+    uint8_t flags;          ///< Verbatim and Side bits
+    size_t offset;          ///< The byte offset of the token in the input
+};
+
+/**
+ * @brief A block of tokens produced by BasicTokenizer::fill().
+ * 
+ * If tokenizing stops at an error, the tokens before it are still valid,
+ * `failed` is set and the block ends with a TokenType::Invalid token at
+ * the error offset. A consumer that rejects Invalid like any unexpected
+ * token therefore needs no per-token error check, and looks at `error`
+ * only once it has stopped there.
+ */
+struct TokenBlock {
+    /// Number of tokens produced per fill() call.
+    static constexpr size_t Capacity = 1024;
+
+    /**
+     * @brief Constructs an empty block; the tokens are left uninitialized.
+     * 
+     * @param resource The memory resource backing the side table.
+     */
+    explicit TokenBlock(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : strings(resource) {}
+
+    std::array<PackedToken, Capacity> tokens;
+    size_t size = 0;                            ///< Valid entries in tokens
+    std::pmr::vector<std::string_view> strings; ///< Side table of strings not in the input
+    bool failed = false;                        ///< Tokenizing stopped at `error`
+    Error error{ErrorCode::None, 0, {}};
+
+    /**
+     * @brief Expands a packed token.
+     * 
+     * @param packed A token of this block.
+     * @param input The input the block was produced from.
+     * @return Token The token with its text.
+     */
+    [[nodiscard]] Token unpack(const PackedToken& packed, std::span<const char> input) const {
+        std::string_view text = packed.flags & PackedToken::Side
+            ? strings[packed.data]
+            : std::string_view(input.data() + packed.offset, packed.data);
+        return Token{packed.type, text, packed.offset, (packed.flags & PackedToken::Verbatim) != 0};
+    }
 };
 
 /**
@@ -55,16 +120,29 @@ struct Token {
  * 
  * The Tokenizer breaks down a raw character buffer into a sequence of Tokens.
  * It handles whitespace skipping and basic validation of token formats.
+ * 
+ * The Policy (see ParsePolicy) fixes at compile time which string checks
+ * are made; it is instantiated for DefaultPolicy, TrustedPolicy,
+ * StrictPolicy and TrustedIntegerPolicy.
+ * 
+ * @tparam Policy A ParsePolicy instantiation.
  */
-class Tokenizer {
+template <typename Policy>
+class BasicTokenizer {
 public:
     /**
      * @brief Constructs a Tokenizer without an arena.
      * 
+     * Strings are checked but their escapes are not decoded: string tokens
+     * hold the raw source text.
+     * 
      * @param input The input character buffer to tokenize.
+     * @param options Parse options; validate_utf8 and max_string_length apply
+     *                here, if the policy reads options at runtime.
      */
-    explicit Tokenizer(std::span<const char> input)
-        : input_(input), pos_(0), arena_(nullptr) {}
+    explicit BasicTokenizer(std::span<const char> input, const ParseOptions& options = {})
+        : input_(input), pos_(0), arena_(nullptr),
+          max_string_length_(options.max_string_length), validate_utf8_(options.validate_utf8) {}
     
     /**
      * @brief Constructs a Tokenizer with a memory arena.
@@ -74,9 +152,12 @@ public:
      * 
      * @param input The input character buffer to tokenize.
      * @param arena The memory arena for allocations.
+     * @param options Parse options; validate_utf8 and max_string_length apply
+     *                here, if the policy reads options at runtime.
      */
-    Tokenizer(std::span<const char> input, Arena& arena)
-        : input_(input), pos_(0), arena_(&arena) {}
+    BasicTokenizer(std::span<const char> input, Arena& arena, const ParseOptions& options = {})
+        : input_(input), pos_(0), arena_(&arena),
+          max_string_length_(options.max_string_length), validate_utf8_(options.validate_utf8) {}
 
     /**
      * @brief Retrieves the next token from the input.
@@ -84,6 +165,17 @@ public:
      * @return Result<Token> The next token found, or an error if the input is invalid.
      */
     Result<Token> next();
+
+    /**
+     * @brief Tokenizes ahead into a block.
+     * 
+     * Replaces the block's contents with up to TokenBlock::Capacity tokens,
+     * stopping after the End token or at the first error, which is recorded
+     * in the block and marked by a final TokenType::Invalid token.
+     * 
+     * @param block The block to fill.
+     */
+    void fill(TokenBlock& block);
     
     /**
      * @brief Gets the current position in the input buffer.
@@ -100,15 +192,52 @@ public:
      */
     [[nodiscard]] bool at_end() const { return pos_ >= input_.size(); }
 
+    /**
+     * @brief Gets the size of the input buffer.
+     * 
+     * @return size_t The input length in bytes.
+     */
+    [[nodiscard]] size_t size() const { return input_.size(); }
+
+    /**
+     * @brief Gets the input buffer.
+     * 
+     * @return std::span<const char> The characters being tokenized.
+     */
+    [[nodiscard]] std::span<const char> input() const { return input_; }
+
 private:
     void skip_whitespace();
     Result<Token> read_string();
+    template <bool Decode>
+    Result<Token> unescape_string(size_t start, size_t scan_pos);
     Result<Token> read_number();
     Result<Token> read_keyword(std::string_view keyword, TokenType type);
+    Result<Token> string_too_long(size_t start) const;
+
+    bool validate_utf8() const {
+        if constexpr (Policy::runtime_options) return validate_utf8_;
+        else return Policy::validate_utf8;
+    }
+
+    bool too_long(size_t length) const {
+        if constexpr (Policy::runtime_options) return length > max_string_length_;
+        else return false;
+    }
 
     std::span<const char> input_;
     size_t pos_;
     Arena* arena_; // Optional: if null, strings won't be unescaped
+    size_t max_string_length_;
+    bool validate_utf8_;
 };
 
+/// Tokenizer configured at runtime through ParseOptions.
+using Tokenizer = BasicTokenizer<DefaultPolicy>;
+
+extern template class BasicTokenizer<DefaultPolicy>;
+extern template class BasicTokenizer<TrustedPolicy>;
+extern template class BasicTokenizer<StrictPolicy>;
+extern template class BasicTokenizer<TrustedIntegerPolicy>;
+
 } // namespace json
@@ -0,0 +1,74 @@
+/**
+ * @file validator.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief JSON Validator API
+ *
+ * This file defines the Validator class, which checks JSON syntax without
+ * constructing an AST.
+ * @version 1.0.0
+ * @date 2026-01-04
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "arena.hpp"
+#include "tokenizer.hpp"
+#include "error.hpp"
+#include "parse_options.hpp"
+#include <bitset>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+/**
+ * @brief Grammar checker that builds no tree.
+ *
+ * The Validator consumes tokens from a Tokenizer constructed without an
+ * arena, so escapes are checked but never decoded and nothing is
+ * allocated. Nesting is tracked with a bit per level instead of recursion.
+ * It accepts exactly the inputs Parser accepts with the same options and
+ * reports the same error codes and offsets. Only DuplicateKeys::Reject
+ * allocates, to keep the keys of open objects.
+ */
+class Validator {
+public:
+    /// Maximum allowed nesting depth, matching Parser.
+    static constexpr size_t MaxDepth = 256;
+
+    /**
+     * @brief Constructs a new Validator object.
+     *
+     * @param tokenizer The source of JSON tokens; should have no arena.
+     * @param options Limits and policies, as given to Parser.
+     */
+    explicit Validator(Tokenizer& tokenizer, const ParseOptions& options = {})
+        : tok_(tokenizer), options_(options) {}
+
+    /**
+     * @brief Checks that the input holds exactly one valid JSON value.
+     *
+     * @return Result<void> Success, or the first error.
+     */
+    Result<void> validate();
+
+private:
+    Result<void> check_number(const Token& token) const;
+    Result<void> add_key(const Token& token);
+    Result<void> check_duplicates();
+
+    Tokenizer& tok_;
+    ParseOptions options_;
+    std::bitset<MaxDepth> objects_;     ///< Whether each open container is an object
+    std::vector<std::pair<std::string, size_t>> keys_;  ///< Keys and offsets of open objects (Reject only)
+    std::vector<size_t> key_bases_;     ///< Start of each open object's keys in keys_
+    std::vector<size_t> order_;         ///< Scratch for sorting an object's keys
+    std::unique_ptr<Arena> scratch_;    ///< Decodes escaped keys (Reject only)
+};
+
+} // namespace json
@@ -13,18 +13,98 @@
 #pragma once
 
 #include "ast.hpp"
+#include "sink.hpp"
 #include <string>
 #include <string_view>
+#include <vector>
 #include <cstdio>
 
 namespace json {
 
+/// Maximum number of characters format_number() writes.
+inline constexpr size_t MaxNumberLength = 32;
+
+/**
+ * @brief Formats a number as JSON text into a caller-provided buffer.
+ * 
+ * Integral values with magnitude below 2^53 are written as plain integer
+ * digits. Other finite values use the shortest representation that parses
+ * back to the same double. NaN and infinities have no JSON representation
+ * and are written as `null`.
+ * 
+ * @param value The number to format.
+ * @param out Destination with room for at least MaxNumberLength characters.
+ * @return char* One past the last character written.
+ */
+char* format_number(double value, char* out) noexcept;
+
+/**
+ * @brief Writes a number as JSON text into a sink.
+ * 
+ * @param value The number to write (see format_number()).
+ * @param out The sink receiving the text.
+ */
+void write_number(double value, Sink& out);
+
+/**
+ * @brief Writes a string as a quoted JSON string literal into a sink.
+ * 
+ * Quotes, backslashes and control characters are escaped; all other bytes,
+ * including UTF-8 sequences, are copied unchanged.
+ * 
+ * @param str The raw string contents.
+ * @param out The sink receiving the literal.
+ */
+void write_string(std::string_view str, Sink& out);
+
+/**
+ * @brief Options controlling the textual form produced by Writer.
+ */
+struct WriterOptions {
+    bool pretty = false;    ///< Emit newlines and indentation
+    int indent_size = 2;    ///< Spaces per indentation level when pretty-printing
+};
+
+/**
+ * @brief Options controlling parallel serialization.
+ */
+struct ParallelOptions {
+    unsigned threads = 0;           ///< Worker threads; 0 uses the hardware concurrency
+    size_t min_chunk_size = 1024;   ///< Fewest container elements handed to one thread
+};
+
+/**
+ * @brief Outcome of serializing into a caller-provided buffer.
+ */
+struct WriteResult {
+    size_t written;     ///< Bytes written into the buffer
+    size_t required;    ///< Exact size of the complete output
+
+    /// Checks whether the whole document fit into the buffer.
+    [[nodiscard]] constexpr bool complete() const { return written == required; }
+};
+
+/**
+ * @brief Computes the exact length of the text Writer produces for a tree.
+ * 
+ * Accounts for escape sequences, number formatting and pretty-print
+ * indentation, so callers can allocate the output buffer once.
+ * 
+ * @param root The root node of the tree.
+ * @param options The options the tree will be written with.
+ * @return size_t The serialized length in bytes.
+ */
+size_t measure(const Node* root, const WriterOptions& options = {});
+
 /**
  * @brief A class for serializing JSON AST nodes into text.
  * 
  * The Writer class provides functionality to convert a hierarchy of Node objects
  * into a JSON string or write it directly to a file stream. It supports
  * optional pretty-printing with configurable indentation.
+ * 
+ * Trees are traversed with an explicit stack rather than recursion, so the
+ * nesting depth is bounded by memory, not by the call stack.
  */
 class Writer {
 public:
@@ -36,34 +116,122 @@ public:
      */
     explicit Writer(bool pretty = false, int indent_size = 2)
         : pretty_(pretty)
-        , indent_size_(indent_size)
-        , indent_(0) {}
+        , indent_size_(indent_size) {}
+
+    /**
+     * @brief Constructs a new Writer object from options.
+     * 
+     * @param options Formatting options.
+     */
+    explicit Writer(const WriterOptions& options)
+        : Writer(options.pretty, options.indent_size) {}
 
     /**
      * @brief Serializes the AST starting from the given root node into a string.
      * 
+     * The output size is measured first, so the string is allocated once.
+     * 
      * @param root A pointer to the root Node of the AST to serialize.
      * @return std::string The JSON string representation of the AST.
      */
     std::string write(const Node* root);
 
+    /**
+     * @brief Serializes the AST into a caller-provided buffer.
+     * 
+     * A buffer of measure() bytes always suffices.
+     * 
+     * @param root A pointer to the root Node of the AST to serialize.
+     * @param out The buffer to write into.
+     * @return WriteResult Bytes written and the size the full output needs.
+     */
+    WriteResult write(const Node* root, std::span<char> out);
+
+    /**
+     * @brief Computes the exact length write() produces for a tree.
+     * 
+     * Like write(), this reuses the writer's container stack, so a Writer
+     * must not be used by several threads at once.
+     * 
+     * @param root A pointer to the root Node of the AST.
+     * @return size_t The serialized length in bytes.
+     */
+    [[nodiscard]] size_t measure(const Node* root);
+
     /**
      * @brief Serializes the AST starting from the given root node to a file stream.
      * 
+     * Output goes through a fixed 64KB buffer, so memory use does not depend
+     * on the document size and bytes are written while serializing.
+     * 
      * @param root A pointer to the root Node of the AST to serialize.
      * @param out The file stream to write to (e.g., stdout or a file handle).
+     * @return true If all output was written successfully.
+     */
+    bool write(const Node* root, FILE* out);
+
+    /**
+     * @brief Serializes the AST starting from the given root node into a sink.
+     * 
+     * The sink is flushed once the whole tree has been written.
+     * 
+     * @param root A pointer to the root Node of the AST to serialize.
+     * @param out The sink receiving the output.
+     * @return true If all output reached the sink's destination.
      */
-    void write(const Node* root, FILE* out);
+    bool write(const Node* root, Sink& out);
+
+    /**
+     * @brief Serializes a large tree on several threads into ordered pieces.
+     * 
+     * The elements of the root container (or of the container below a chain
+     * of single-element wrappers, e.g. `{"items": [...]}`) are split into
+     * contiguous chunks that are written concurrently. Concatenating the
+     * pieces in order yields exactly the output of write(root); they can
+     * also be handed to write_gather() without joining them. Small trees
+     * produce a single piece written on the calling thread.
+     * 
+     * @param root A pointer to the root Node of the AST to serialize.
+     * @param parallel Thread count and chunking threshold.
+     * @return std::vector<std::string> The output pieces, in order.
+     */
+    std::vector<std::string> write_chunks(const Node* root, const ParallelOptions& parallel = {});
+
+    /**
+     * @brief Serializes a large tree on several threads into a string.
+     * 
+     * @param root A pointer to the root Node of the AST to serialize.
+     * @param parallel Thread count and chunking threshold.
+     * @return std::string The JSON string representation of the AST.
+     */
+    std::string write_parallel(const Node* root, const ParallelOptions& parallel = {});
+
+    /**
+     * @brief Serializes a large tree on several threads into a sink.
+     * 
+     * @param root A pointer to the root Node of the AST to serialize.
+     * @param out The sink receiving the output; flushed when done.
+     * @param parallel Thread count and chunking threshold.
+     * @return true If all output reached the sink's destination.
+     */
+    bool write_parallel(const Node* root, Sink& out, const ParallelOptions& parallel = {});
 
 private:
-    void write_node(const Node* node, std::string& out);
-    void write_string(std::string_view str, std::string& out);
-    void write_indent(std::string& out);
-    void write_newline(std::string& out);
+    /// A container being written and the index of its next element.
+    struct Frame {
+        const Node* node;
+        size_t next;
+    };
+
+    void write_node(const Node* root, Sink& out, size_t depth = 0);
+    void write_elements(const Node* container, size_t begin, size_t end, size_t depth, Sink& out);
+    void write_scalar(const Node* node, Sink& out);
+    void write_newline_indent(size_t depth, Sink& out);
 
     bool pretty_;
     int indent_size_;
-    int indent_;
+    std::vector<Frame> stack_;          ///< Open containers; reused across calls
+    std::string indentation_;           ///< '\n' followed by spaces, grown on demand
 };
 
 } // namespace json
@@ -1,21 +1,117 @@
 #include "json/api.hpp"
 #include "json/tokenizer.hpp"
 #include "json/parser.hpp"
+#include "json/validator.hpp"
 #include "json/writer.hpp"
+#include <algorithm>
 #include <fstream>
+#include <memory_resource>
 #include <sstream>
 #include <cstring>
+#include <thread>
 
 namespace json {
 
-Result<Node*> parse(std::span<const char> input, Arena& arena) {
-    Tokenizer tokenizer(input, arena); // Pass arena for string unescaping
-    Parser parser(arena, tokenizer);
+Result<Node*> parse(std::span<const char> input, Arena& arena, const ParseOptions& options) {
+    Tokenizer tokenizer(input, arena, options); // Pass arena for string unescaping
+    Parser parser(arena, tokenizer, options);
     return parser.parse();
 }
 
-Result<Node*> parse(std::string_view input, Arena& arena) {
-    return parse(std::span{input.data(), input.size()}, arena);
+Result<Node*> parse(std::string_view input, Arena& arena, const ParseOptions& options) {
+    return parse(std::span{input.data(), input.size()}, arena, options);
+}
+
+Result<void> validate(std::span<const char> input, const ParseOptions& options) {
+    Tokenizer tokenizer(input, options); // No arena: escapes are checked, not decoded
+    Validator validator(tokenizer, options);
+    return validator.validate();
+}
+
+Result<void> validate(std::string_view input, const ParseOptions& options) {
+    return validate(std::span{input.data(), input.size()}, options);
+}
+
+Result<Document> parse_document(std::span<const char> input, size_t block_size,
+                                std::pmr::memory_resource* upstream) {
+    Arena arena(block_size, upstream);
+    auto root = parse(input, arena);
+    if (!root) return std::unexpected(root.error());
+    return Document(std::move(arena), *root);
+}
+
+Result<Document> parse_document(std::string_view input, size_t block_size,
+                                std::pmr::memory_resource* upstream) {
+    return parse_document(std::span{input.data(), input.size()}, block_size, upstream);
+}
+
+Result<Document> parse_document_file(const char* filename, size_t block_size,
+                                     std::pmr::memory_resource* upstream) {
+    auto file = MappedFile::open(filename);
+    if (!file) return std::unexpected(file.error());
+
+    Arena arena(block_size, upstream);
+    auto root = parse(file->data(), arena);
+    if (!root) return std::unexpected(root.error());
+    return Document(std::move(arena), *root, std::move(*file));
+}
+
+namespace {
+
+/// Parses `inputs` into `arena` with one reused parser, storing into `out`.
+void parse_range(std::span<const std::span<const char>> inputs, Arena& arena, Result<Node*>* out,
+                 std::pmr::memory_resource* scratch = nullptr) {
+    if (inputs.empty()) return;
+    Tokenizer tokenizer(inputs[0], arena);
+    Parser parser(arena, tokenizer, {}, scratch);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        tokenizer = Tokenizer(inputs[i], arena);
+        out[i] = parser.parse(tokenizer);
+    }
+}
+
+} // namespace
+
+std::vector<Result<Node*>> parse_batch(std::span<const std::span<const char>> inputs, Arena& arena) {
+    std::vector<Result<Node*>> results(inputs.size());
+    parse_range(inputs, arena, results.data());
+    return results;
+}
+
+std::vector<Result<Node*>> parse_batch(std::span<const std::span<const char>> inputs,
+                                       ConcurrentArena& arena, unsigned threads,
+                                       size_t block_size) {
+    std::vector<Result<Node*>> results(inputs.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = std::min<size_t>(threads, inputs.size());
+    if (count == 0) return results;
+
+    // Thread arenas only hand blocks back to `arena`, which frees nothing
+    // before its own destruction, so the trees outlive them. The parser's
+    // scratch buffers are freed as they grow, so they come from a pool on
+    // the arena's upstream rather than piling up in `arena`
+    auto run = [&](size_t begin, size_t end) {
+        Arena local(block_size, &arena);
+        std::pmr::unsynchronized_pool_resource scratch(arena.upstream());
+        parse_range(inputs.subspan(begin, end - begin), local, results.data() + begin, &scratch);
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(count - 1);
+    size_t per_thread = inputs.size() / count;
+    size_t extra = inputs.size() % count;
+    size_t begin = 0;
+    for (size_t t = 0; t < count; ++t) {
+        size_t end = begin + per_thread + (t < extra ? 1 : 0);
+        if (t + 1 == count) {
+            run(begin, end);
+        } else {
+            workers.emplace_back(run, begin, end);
+        }
+        begin = end;
+    }
+    workers.clear();    // Join before handing out the results
+    return results;
 }
 
 std::string write(const Node* root, bool pretty) {
@@ -23,6 +119,31 @@ std::string write(const Node* root, bool pretty) {
     return writer.write(root);
 }
 
+bool write(const Node* root, Sink& sink, bool pretty) {
+    Writer writer(pretty);
+    return writer.write(root, sink);
+}
+
+WriteResult write(const Node* root, std::span<char> out, bool pretty) {
+    Writer writer(pretty);
+    return writer.write(root, out);
+}
+
+Result<std::string_view> write(const Node* root, Arena& arena, bool pretty) {
+    Writer writer(pretty);
+    size_t size = writer.measure(root);
+    char* buffer = arena.alloc<char>(size);
+    if (!buffer) {
+        return std::unexpected(Error{
+            ErrorCode::OutOfMemory,
+            0,
+            "Arena allocation failed"
+        });
+    }
+    writer.write(root, std::span<char>(buffer, size));
+    return std::string_view(buffer, size);
+}
+
 Result<Node*> read_file_to_arena(const char* filename, Arena& arena) {
     // Open file
     std::ifstream file(filename, std::ios::binary | std::ios::ate);
@@ -0,0 +1,95 @@
+#include "json/async_loader.hpp"
+#include "json/api.hpp"
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace json {
+
+AsyncLoader::AsyncLoader(unsigned threads, size_t block_size, std::pmr::memory_resource* upstream)
+    : block_size_(block_size), upstream_(upstream) {
+    if (threads == 0) threads = std::max(2u, 2 * std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] { run(); });
+    }
+}
+
+AsyncLoader::~AsyncLoader() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+std::future<Result<Document>> AsyncLoader::load(std::string path) {
+    // std::function needs a copyable target, so the promise is shared
+    auto promise = std::make_shared<std::promise<Result<Document>>>();
+    auto future = promise->get_future();
+    enqueue(Job{std::move(path), [promise](const std::string&, Result<Document>&& result) {
+        promise->set_value(std::move(result));
+    }});
+    return future;
+}
+
+void AsyncLoader::load(std::string path, Callback callback) {
+    enqueue(Job{std::move(path), [callback = std::move(callback)](const std::string& path,
+                                                                  Result<Document>&& result) {
+        callback(path, std::move(result));
+    }});
+}
+
+void AsyncLoader::wait() {
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return pending_ == 0; });
+}
+
+size_t AsyncLoader::pending() const {
+    std::lock_guard lock(mutex_);
+    return pending_;
+}
+
+void AsyncLoader::enqueue(Job job) {
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back(std::move(job));
+        ++pending_;
+    }
+    ready_.notify_one();
+}
+
+void AsyncLoader::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            // Drain the queue before honoring shutdown
+            if (queue_.empty()) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        job.done(job.path, load_now(job.path));
+
+        bool idle;
+        {
+            std::lock_guard lock(mutex_);
+            idle = --pending_ == 0;
+        }
+        if (idle) idle_.notify_all();
+    }
+}
+
+Result<Document> AsyncLoader::load_now(const std::string& path) const {
+    try {
+        return parse_document_file(path.c_str(), block_size_, upstream_);
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0,
+                                   error_message(ErrorCode::OutOfMemory)});
+    }
+}
+
+} // namespace json
@@ -0,0 +1,204 @@
+#include "json/canonical.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace json {
+
+char* format_canonical_number(double value, char* out) noexcept {
+    if (value == 0) {
+        // Covers negative zero
+        *out++ = '0';
+        return out;
+    }
+
+    // Integers up to 2^53 print as plain digits in both notations
+    constexpr double ExactLimit = 9007199254740992.0;
+    if (value > -ExactLimit && value < ExactLimit && value == std::trunc(value)) {
+        return format_number(value, out);
+    }
+
+    // Shortest round-trip digits in the form [-]d[.ddd]e(+|-)x
+    char buffer[MaxNumberLength];
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                              std::chars_format::scientific).ptr;
+    char* p = buffer;
+    if (*p == '-') {
+        *out++ = '-';
+        ++p;
+    }
+    char* e = std::find(p, end, 'e');
+    char digits[MaxNumberLength];
+    int k = 0;
+    for (char* q = p; q < e; ++q) {
+        if (*q != '.') digits[k++] = *q;
+    }
+    int exponent = 0;
+    std::from_chars(e + (e[1] == '+' ? 2 : 1), end, exponent);
+
+    // Position of the decimal point relative to the digits (ECMA-262 Number::toString)
+    int n = exponent + 1;
+    if (k <= n && n <= 21) {
+        std::memcpy(out, digits, static_cast<size_t>(k));
+        out += k;
+        std::memset(out, '0', static_cast<size_t>(n - k));
+        return out + (n - k);
+    }
+    if (0 < n && n <= 21) {
+        std::memcpy(out, digits, static_cast<size_t>(n));
+        out += n;
+        *out++ = '.';
+        std::memcpy(out, digits + n, static_cast<size_t>(k - n));
+        return out + (k - n);
+    }
+    if (-6 < n && n <= 0) {
+        *out++ = '0';
+        *out++ = '.';
+        std::memset(out, '0', static_cast<size_t>(-n));
+        out += -n;
+        std::memcpy(out, digits, static_cast<size_t>(k));
+        return out + k;
+    }
+
+    *out++ = digits[0];
+    if (k > 1) {
+        *out++ = '.';
+        std::memcpy(out, digits + 1, static_cast<size_t>(k - 1));
+        out += k - 1;
+    }
+    *out++ = 'e';
+    *out++ = n - 1 < 0 ? '-' : '+';
+    return std::to_chars(out, out + 4, std::abs(n - 1)).ptr;
+}
+
+bool utf16_less(std::string_view a, std::string_view b) noexcept {
+    size_t size = std::min(a.size(), b.size());
+    size_t i = static_cast<size_t>(std::mismatch(a.begin(), a.begin() + size, b.begin()).first - a.begin());
+    if (i == size) return a.size() < b.size();
+
+    auto x = static_cast<unsigned char>(a[i]);
+    auto y = static_cast<unsigned char>(b[i]);
+    // Lead bytes of U+10000 and up (0xF0..0xF4) become surrogates (0xD800..)
+    // in UTF-16 and sort before U+E000..U+FFFF (lead bytes 0xEE, 0xEF)
+    if (x >= 0xEE && y >= 0xEE && (x >= 0xF0) != (y >= 0xF0)) return x >= 0xF0;
+    return x < y;
+}
+
+Result<std::string> CanonicalWriter::write(const Node* root) {
+    std::string result;
+    StringSink sink(result);
+    if (!write_node(root, sink)) {
+        return std::unexpected(Error{ErrorCode::InvalidNumber, 0,
+                                   error_message(ErrorCode::InvalidNumber)});
+    }
+    sink.flush();
+    return result;
+}
+
+Result<void> CanonicalWriter::write(const Node* root, Sink& out) {
+    if (!write_node(root, out)) {
+        return std::unexpected(Error{ErrorCode::InvalidNumber, 0,
+                                   error_message(ErrorCode::InvalidNumber)});
+    }
+    if (!out.flush()) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Failed to write output"});
+    }
+    return {};
+}
+
+bool CanonicalWriter::write_node(const Node* root, Sink& out) {
+    stack_.clear();
+    order_.clear();
+    const Node* node = root;
+    while (true) {
+        if (node && node->type == NodeType::Array && node->array_val.size > 0) {
+            out.put('[');
+            stack_.push_back(Frame{node, 0, 0});
+        } else if (node && node->type == NodeType::Object && node->object_val.size > 0) {
+            out.put('{');
+            // Sort pointers to the members; the tree keeps its order
+            size_t start = order_.size();
+            for (const ObjectPair& pair : node->object_val) order_.push_back(&pair);
+            std::sort(order_.begin() + static_cast<std::ptrdiff_t>(start), order_.end(),
+                      [](const ObjectPair* a, const ObjectPair* b) {
+                          return utf16_less(a->key.view(), b->key.view());
+                      });
+            stack_.push_back(Frame{node, 0, start});
+        } else if (!write_scalar(node, out)) {
+            return false;
+        }
+
+        // Find the next element, closing containers that are done
+        node = nullptr;
+        while (!stack_.empty()) {
+            Frame& top = stack_.back();
+            bool is_object = top.node->type == NodeType::Object;
+            size_t count = is_object ? top.node->object_val.size : top.node->array_val.size;
+            if (top.next == count) {
+                if (is_object) order_.resize(top.order);
+                stack_.pop_back();
+                out.put(is_object ? '}' : ']');
+                continue;
+            }
+
+            if (top.next > 0) out.put(',');
+            if (is_object) {
+                const ObjectPair* pair = order_[top.order + top.next++];
+                write_string(pair->key.view(), out);
+                out.put(':');
+                node = pair->value;
+            } else {
+                node = top.node->array_val.data[top.next++];
+            }
+            break;
+        }
+        if (stack_.empty() && !node) return true;
+    }
+}
+
+bool CanonicalWriter::write_scalar(const Node* node, Sink& out) {
+    if (!node) {
+        out.append("null");
+        return true;
+    }
+
+    switch (node->type) {
+        case NodeType::Null:
+            out.append("null");
+            break;
+
+        case NodeType::Bool:
+            out.append(node->bool_val ? std::string_view("true") : std::string_view("false"));
+            break;
+
+        case NodeType::Number: {
+            if (!std::isfinite(node->number_val)) return false;
+            char buffer[MaxNumberLength];
+            char* end = format_canonical_number(node->number_val, buffer);
+            out.append(buffer, static_cast<size_t>(end - buffer));
+            break;
+        }
+
+        case NodeType::String:
+            if (node->has_flag(NodeFlag::Verbatim)) {
+                out.put('"');
+                out.append(node->string_val.data, node->string_val.size);
+                out.put('"');
+            } else {
+                write_string(node->string_val.view(), out);
+            }
+            break;
+
+        case NodeType::Array:
+            out.append("[]");
+            break;
+
+        case NodeType::Object:
+            out.append("{}");
+            break;
+    }
+    return true;
+}
+
+} // namespace json
@@ -0,0 +1,136 @@
+#include "json/clone.hpp"
+#include <cstring>
+#include <vector>
+
+namespace json {
+
+static_assert(sizeof(Node) % alignof(Node) == 0 &&
+              alignof(Node*) <= alignof(Node) && sizeof(Node*) % alignof(Node) == 0 &&
+              alignof(ObjectPair) <= alignof(Node) && sizeof(ObjectPair) % alignof(Node) == 0,
+              "Packed layout requires node, slot and pair tables to need no padding");
+
+namespace {
+
+struct CompactLayout {
+    size_t nodes = 0;   // Number of nodes
+    size_t slots = 0;   // Array element pointers
+    size_t pairs = 0;   // Object key-value pairs
+    size_t chars = 0;   // String and key bytes
+
+    size_t bytes() const {
+        return nodes * sizeof(Node) + slots * sizeof(Node*) +
+               pairs * sizeof(ObjectPair) + chars;
+    }
+};
+
+CompactLayout measure_layout(const Node* root) {
+    CompactLayout layout;
+    if (!root) return layout;
+
+    // Explicit stack: builder-made trees have no depth limit
+    std::vector<const Node*> stack{root};
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        ++layout.nodes;
+
+        switch (node->type) {
+            case NodeType::String:
+                layout.chars += node->string_val.size;
+                break;
+            case NodeType::Array:
+                layout.slots += node->array_val.size;
+                for (Node* child : node->array_val) {
+                    if (child) stack.push_back(child);
+                }
+                break;
+            case NodeType::Object:
+                layout.pairs += node->object_val.size;
+                for (const ObjectPair& pair : node->object_val) {
+                    layout.chars += pair.key.size;
+                    if (pair.value) stack.push_back(pair.value);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return layout;
+}
+
+} // namespace
+
+size_t compact_size(const Node* root) {
+    return measure_layout(root).bytes();
+}
+
+Result<Node*> clone_compact(const Node* root, Arena& dst) {
+    if (!root) return nullptr;
+
+    CompactLayout layout = measure_layout(root);
+    auto* region = static_cast<char*>(dst.allocate(layout.bytes(), alignof(Node)));
+    if (!region) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0,
+                                   error_message(ErrorCode::OutOfMemory)});
+    }
+
+    Node* nodes = reinterpret_cast<Node*>(region);
+    Node** slots = reinterpret_cast<Node**>(region + layout.nodes * sizeof(Node));
+    ObjectPair* pairs = reinterpret_cast<ObjectPair*>(slots + layout.slots);
+    char* chars = reinterpret_cast<char*>(pairs + layout.pairs);
+
+    auto copy_chars = [&chars](StringView str) -> StringView {
+        if (str.size > 0) std::memcpy(chars, str.data, str.size);
+        StringView copy{chars, str.size};
+        chars += str.size;
+        return copy;
+    };
+
+    // Breadth-first: the node table doubles as the work queue. Each entry is
+    // first a shallow copy of its source, then rewritten to point into the region.
+    size_t count = 0;
+    nodes[count++] = *root;
+    for (size_t i = 0; i < count; ++i) {
+        Node& node = nodes[i];
+        switch (node.type) {
+            case NodeType::String:
+                node.string_val = copy_chars(node.string_val);
+                break;
+            case NodeType::Array: {
+                Node** out = slots;
+                for (size_t j = 0; j < node.array_val.size; ++j) {
+                    Node* child = node.array_val.data[j];
+                    if (child) {
+                        nodes[count] = *child;
+                        child = &nodes[count++];
+                    }
+                    out[j] = child;
+                }
+                node.array_val.data = out;
+                slots += node.array_val.size;
+                break;
+            }
+            case NodeType::Object: {
+                ObjectPair* out = pairs;
+                for (size_t j = 0; j < node.object_val.size; ++j) {
+                    const ObjectPair& pair = node.object_val.data[j];
+                    Node* value = pair.value;
+                    if (value) {
+                        nodes[count] = *value;
+                        value = &nodes[count++];
+                    }
+                    out[j] = ObjectPair{copy_chars(pair.key), value};
+                }
+                node.object_val.data = out;
+                pairs += node.object_val.size;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return nodes;
+}
+
+} // namespace json
@@ -0,0 +1,34 @@
+#pragma once
+
+// Internal duplicate-key search shared by the parser and the validator, so
+// that parse() and validate() report the same repeated key.
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+
+namespace json::keys {
+
+/// Fills `order` with the member indices 0..count-1 sorted by `key(i)`;
+/// members with equal keys stay in input order.
+template <typename Order, typename KeyOf>
+void sort_members(Order& order, size_t count, KeyOf key) {
+    order.resize(count);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return key(a) < key(b); });
+}
+
+/// Finds the repeated key that comes first in the input, given `order`
+/// from sort_members(). Returns its member index, or `count` if all keys
+/// are distinct.
+template <typename Order, typename KeyOf>
+size_t first_repeat(const Order& order, size_t count, KeyOf key) {
+    size_t first = count;
+    for (size_t i = 1; i < count; ++i) {
+        if (key(order[i]) == key(order[i - 1])) first = std::min(first, order[i]);
+    }
+    return first;
+}
+
+} // namespace json::keys
@@ -0,0 +1,75 @@
+#include "json/mapped_file.hpp"
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace json {
+
+Result<MappedFile> MappedFile::open(const char* filename) {
+    MappedFile file;
+
+#if defined(_WIN32)
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Cannot open file"});
+    }
+    std::streamsize size = stream.tellg();
+    if (size < 0) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Cannot determine file size"});
+    }
+    stream.seekg(0, std::ios::beg);
+    file.size_ = static_cast<size_t>(size);
+    if (file.size_ > 0) {
+        file.buffer_ = std::make_unique<char[]>(file.size_);
+        if (!stream.read(file.buffer_.get(), size)) {
+            return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Failed to read file"});
+        }
+        file.data_ = file.buffer_.get();
+    }
+#else
+    int fd = ::open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Cannot open file"});
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < 0) {
+        ::close(fd);
+        return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Cannot determine file size"});
+    }
+    file.size_ = static_cast<size_t>(info.st_size);
+    if (file.size_ > 0) {
+        void* mapping = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            return std::unexpected(Error{ErrorCode::OutOfMemory, 0, "Failed to map file"});
+        }
+        // Parsing reads front to back exactly once: read ahead aggressively
+        ::madvise(mapping, file.size_, MADV_SEQUENTIAL);
+        ::madvise(mapping, file.size_, MADV_WILLNEED);
+        file.data_ = static_cast<const char*>(mapping);
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+#endif
+
+    return file;
+}
+
+void MappedFile::release() noexcept {
+#if !defined(_WIN32)
+    if (data_ && !buffer_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    buffer_.reset();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace json
@@ -0,0 +1,32 @@
+#pragma once
+
+// Internal number checks shared by the parser and the validator, so that
+// parse() and validate() accept exactly the same numbers.
+
+#include "json/error.hpp"
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+namespace json::number {
+
+/// Largest magnitude at which every integer is exact in a double (2^53).
+constexpr int64_t MaxExact = int64_t{1} << 53;
+
+/// Converts a number token for NumberMode::Integer: an integer without
+/// fraction or exponent, |n| <= 2^53. Converted as an integer because
+/// values just above 2^53 round to it as doubles.
+inline Result<double> exact_integer(std::string_view text, size_t offset) {
+    int64_t integer = 0;
+    auto exact = std::from_chars(text.data(), text.data() + text.size(), integer);
+    if (exact.ec != std::errc{} || exact.ptr != text.data() + text.size() ||
+        integer > MaxExact || integer < -MaxExact) {
+        return std::unexpected(Error{ErrorCode::InvalidNumber, offset,
+                                   "Number is not an exact integer"});
+    }
+    return static_cast<double>(integer);
+}
+
+} // namespace json::number
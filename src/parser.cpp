@@ -1,150 +1,255 @@
 #include "json/parser.hpp"
-#include <vector>
+#include "keys.hpp"
+#include "number.hpp"
+#include <algorithm>
 #include <charconv>
 
 namespace json {
 
-Result<Node*> Parser::parse() {
-    auto result = parse_value();
+template <typename Policy>
+Result<Node*> BasicParser<Policy>::parse() {
+    Result<Node*> result;
+    if constexpr (Policy::runtime_options) {
+        if (tok_->size() > options_.max_document_size) {
+            return std::unexpected(Error{ErrorCode::TooLarge, options_.max_document_size,
+                                       error_message(ErrorCode::TooLarge)});
+        }
+        result = checked_ ? parse_root<true>() : parse_root<false>();
+    } else {
+        result = parse_root<false>();
+    }
+
+    // Tokenizer errors reach the parser as an Invalid token, which every
+    // routine rejects; report the tokenizer's error in place of that
+    if (!result && has_current_ && current_.type == TokenType::Invalid) [[unlikely]] {
+        return std::unexpected(block_ ? block_->error : error_);
+    }
+    return result;
+}
+
+template <typename Policy>
+template <bool Checked>
+Result<Node*> BasicParser<Policy>::parse_root() {
+    auto result = parse_value<Checked>();
     if (!result) return result;
 
     // Verify we're at end of input
-    auto token = peek();
-    if (!token) return std::unexpected(token.error());
-    
-    if (token->type != TokenType::End) {
-        return std::unexpected(Error{ErrorCode::UnexpectedToken, token->offset,
+    const Token& token = peek();
+    if (token.type != TokenType::End) {
+        return std::unexpected(Error{ErrorCode::UnexpectedToken, token.offset,
                                    error_message(ErrorCode::UnexpectedToken)});
     }
 
     return result;
 }
 
-Result<Token> Parser::peek() {
+template <typename Policy>
+Result<Node*> BasicParser<Policy>::parse(BasicTokenizer<Policy>& tokenizer) {
+    tok_ = &tokenizer;
+    has_current_ = false;
+    depth_ = 0;
+    elements_.clear();
+    pairs_.clear();
+    key_offsets_.clear();
+    if (block_) {
+        block_->size = 0;
+        cursor_ = 0;
+    }
+    return parse();
+}
+
+template <typename Policy>
+const Token& BasicParser<Policy>::peek() {
     if (!has_current_) {
-        auto token = tok_.next();
-        if (!token) return token;
-        current_ = *token;
+        if (block_) {
+            // A block always ends with End or Invalid, after which nothing
+            // is read, so refilling needs no error check
+            if (cursor_ == block_->size) {
+                tok_->fill(*block_);
+                cursor_ = 0;
+            }
+            current_ = block_->unpack(block_->tokens[cursor_++], tok_->input());
+        } else {
+            auto token = tok_->next();
+            if (token) [[likely]] {
+                current_ = *token;
+            } else {
+                error_ = token.error();
+                current_ = Token{TokenType::Invalid, {}, error_.offset};
+            }
+        }
         has_current_ = true;
     }
     return current_;
 }
 
-void Parser::consume() {
+template <typename Policy>
+void BasicParser<Policy>::consume() {
     has_current_ = false;
 }
 
-Result<Token> Parser::expect(TokenType type) {
-    auto token = peek();
-    if (!token) return token;
-    
-    if (token->type != type) {
-        return std::unexpected(Error{ErrorCode::UnexpectedToken, token->offset,
+template <typename Policy>
+Result<Node*> BasicParser<Policy>::new_node(const Node& value, size_t offset) {
+    Node* node = arena_.alloc<Node>();
+    if (!node) [[unlikely]] {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, offset,
+                                   error_message(ErrorCode::OutOfMemory)});
+    }
+    *node = value;
+    return node;
+}
+
+template <typename Policy>
+Result<void> BasicParser<Policy>::expect(TokenType type) {
+    const Token& token = peek();
+    if (token.type != type) {
+        return std::unexpected(Error{ErrorCode::UnexpectedToken, token.offset,
                                    error_message(ErrorCode::UnexpectedToken)});
     }
     
     consume();
-    return token;
+    return {};
 }
 
-Result<Node*> Parser::parse_value() {
-    auto token = peek();
-    if (!token) return std::unexpected(token.error());
+template <typename Policy>
+Result<double> BasicParser<Policy>::read_integer(const Token& token) const {
+    return number::exact_integer(token.text, token.offset);
+}
 
-    switch (token->type) {
+template <typename Policy>
+Result<void> BasicParser<Policy>::apply_duplicate_policy(size_t base) {
+    size_t count = pairs_.size() - base;
+    if (options_.duplicate_keys == DuplicateKeys::Keep || count < 2) return {};
+
+    auto key = [&](size_t i) { return pairs_[base + i].key.view(); };
+    keys::sort_members(order_, count, key);
+
+    if (options_.duplicate_keys == DuplicateKeys::Reject) {
+        size_t first = keys::first_repeat(order_, count, key);
+        if (first == count) return {};
+        return std::unexpected(Error{ErrorCode::DuplicateKey, key_offsets_[base + first],
+                                   error_message(ErrorCode::DuplicateKey)});
+    }
+
+    // KeepLast: drop every member followed by one with the same key
+    bool dropped = false;
+    for (size_t i = 0; i + 1 < count; ++i) {
+        if (key(order_[i]) == key(order_[i + 1])) {
+            pairs_[base + order_[i]].value = nullptr;
+            dropped = true;
+        }
+    }
+    if (dropped) {
+        auto end = std::remove_if(pairs_.begin() + static_cast<ptrdiff_t>(base), pairs_.end(),
+                                  [](const ObjectPair& pair) { return pair.value == nullptr; });
+        pairs_.erase(end, pairs_.end());
+    }
+    return {};
+}
+
+template <typename Policy>
+template <bool Checked>
+Result<Node*> BasicParser<Policy>::parse_value() {
+    const Token& token = peek();
+
+    switch (token.type) {
         case TokenType::Null: {
             consume();
-            Node* node = arena_.alloc<Node>();
-            *node = Node::make_null();
-            return node;
+            return new_node(Node::make_null(), token.offset);
         }
             
         case TokenType::True:
         case TokenType::False: {
-            bool val = token->type == TokenType::True;
+            bool val = token.type == TokenType::True;
             consume();
-            Node* node = arena_.alloc<Node>();
-            *node = Node::make_bool(val);
-            return node;
+            return new_node(Node::make_bool(val), token.offset);
         }
             
         case TokenType::Number: {
             double val;
-            auto result = std::from_chars(token->text.data(), 
-                                         token->text.data() + token->text.size(), 
-                                         val);
-            if (result.ec != std::errc{}) {
-                return std::unexpected(Error{ErrorCode::InvalidNumber, token->offset,
-                                           error_message(ErrorCode::InvalidNumber)});
+            if constexpr (IntegersOnly) {
+                auto integer = read_integer(token);
+                if (!integer) return std::unexpected(integer.error());
+                val = *integer;
+            } else {
+                auto result = std::from_chars(token.text.data(), 
+                                             token.text.data() + token.text.size(), 
+                                             val);
+                if (result.ec != std::errc{}) {
+                    return std::unexpected(Error{ErrorCode::InvalidNumber, token.offset,
+                                               error_message(ErrorCode::InvalidNumber)});
+                }
+                if constexpr (Checked) {
+                    if (options_.number_mode == NumberMode::Integer) {
+                        if (auto integer = read_integer(token); !integer) {
+                            return std::unexpected(integer.error());
+                        }
+                    }
+                }
             }
             consume();
-            Node* node = arena_.alloc<Node>();
-            *node = Node::make_number(val);
-            return node;
+            return new_node(Node::make_number(val), token.offset);
         }
             
         case TokenType::String: {
             // String content has already been unescaped by tokenizer
             // Extract string content (remove quotes)
-            std::string_view text = token->text;
+            std::string_view text = token.text;
             if (text.size() >= 2) {
                 text = text.substr(1, text.size() - 2);
             }
+            Node node = Node::make_string(text.data(), text.size());
+            if (token.verbatim) node.flags = static_cast<uint8_t>(NodeFlag::Verbatim);
             consume();
-            Node* node = arena_.alloc<Node>();
-            *node = Node::make_string(text.data(), text.size());
-            return node;
+            return new_node(node, token.offset);
         }
             
         case TokenType::LeftBracket:
-            return parse_array();
+            return parse_array<Checked>();
             
         case TokenType::LeftBrace:
-            return parse_object();
+            return parse_object<Checked>();
             
         default:
-            return std::unexpected(Error{ErrorCode::ExpectedValue, token->offset,
+            return std::unexpected(Error{ErrorCode::ExpectedValue, token.offset,
                                        error_message(ErrorCode::ExpectedValue)});
     }
 }
 
-Result<Node*> Parser::parse_array() {
-    if (++depth_ > MaxDepth) {
-        return std::unexpected(Error{ErrorCode::TooDeep, tok_.position(),
+template <typename Policy>
+template <bool Checked>
+Result<Node*> BasicParser<Policy>::parse_array() {
+    size_t max_depth = Checked ? std::min(options_.max_depth, MaxDepth) : MaxDepth;
+    if (++depth_ > max_depth) {
+        return std::unexpected(Error{ErrorCode::TooDeep, current_.offset + 1,
                                    error_message(ErrorCode::TooDeep)});
     }
 
     auto left = expect(TokenType::LeftBracket);
     if (!left) return std::unexpected(left.error());
 
-    std::vector<Node*> elements;
-
-    auto token = peek();
-    if (!token) return std::unexpected(token.error());
+    // Elements are gathered on the shared stack above those of enclosing arrays
+    size_t base = elements_.size();
 
-    if (token->type == TokenType::RightBracket) {
+    if (peek().type == TokenType::RightBracket) {
         consume();
         --depth_;
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_array(nullptr, 0);
-        return node;
+        return new_node(Node::make_array(nullptr, 0), current_.offset);
     }
 
     while (true) {
-        auto element = parse_value();
+        auto element = parse_value<Checked>();
         if (!element) return element;
-        elements.push_back(*element);
+        elements_.push_back(*element);
 
-        token = peek();
-        if (!token) return std::unexpected(token.error());
-
-        if (token->type == TokenType::RightBracket) {
+        const Token& token = peek();
+        if (token.type == TokenType::RightBracket) {
             consume();
             break;
         }
 
-        if (token->type != TokenType::Comma) {
-            return std::unexpected(Error{ErrorCode::ExpectedComma, token->offset,
+        if (token.type != TokenType::Comma) {
+            return std::unexpected(Error{ErrorCode::ExpectedComma, token.offset,
                                        error_message(ErrorCode::ExpectedComma)});
         }
         consume();
@@ -153,36 +258,37 @@ Result<Node*> Parser::parse_array() {
     --depth_;
 
     // Copy to arena
-    Node** arr = arena_.alloc<Node*>(elements.size());
-    for (size_t i = 0; i < elements.size(); ++i) {
-        arr[i] = elements[i];
+    size_t count = elements_.size() - base;
+    Node** arr = arena_.alloc<Node*>(count);
+    if (!arr) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, current_.offset,
+                                   error_message(ErrorCode::OutOfMemory)});
     }
+    std::copy(elements_.begin() + static_cast<ptrdiff_t>(base), elements_.end(), arr);
+    elements_.resize(base);
 
-    Node* node = arena_.alloc<Node>();
-    *node = Node::make_array(arr, elements.size());
-    return node;
+    return new_node(Node::make_array(arr, count), current_.offset);
 }
 
-Result<Node*> Parser::parse_object() {
-    if (++depth_ > MaxDepth) {
-        return std::unexpected(Error{ErrorCode::TooDeep, tok_.position(),
+template <typename Policy>
+template <bool Checked>
+Result<Node*> BasicParser<Policy>::parse_object() {
+    size_t max_depth = Checked ? std::min(options_.max_depth, MaxDepth) : MaxDepth;
+    if (++depth_ > max_depth) {
+        return std::unexpected(Error{ErrorCode::TooDeep, current_.offset + 1,
                                    error_message(ErrorCode::TooDeep)});
     }
 
     auto left = expect(TokenType::LeftBrace);
     if (!left) return std::unexpected(left.error());
 
-    std::vector<ObjectPair> pairs;
+    // Members are gathered on the shared stack above those of enclosing objects
+    size_t base = pairs_.size();
 
-    auto token = peek();
-    if (!token) return std::unexpected(token.error());
-
-    if (token->type == TokenType::RightBrace) {
+    if (peek().type == TokenType::RightBrace) {
         consume();
         --depth_;
-        Node* node = arena_.alloc<Node>();
-        *node = Node::make_object(nullptr, 0);
-        return node;
+        return new_node(Node::make_object(nullptr, 0), current_.offset);
     }
 
     while (true) {
@@ -191,7 +297,8 @@ Result<Node*> Parser::parse_object() {
 
         // String content has already been unescaped by tokenizer
         // Extract string content (remove quotes)
-        std::string_view key_text = key->text;
+        std::string_view key_text = current_.text;
+        size_t key_offset = current_.offset;
         if (key_text.size() >= 2) {
             key_text = key_text.substr(1, key_text.size() - 2);
         }
@@ -199,21 +306,20 @@ Result<Node*> Parser::parse_object() {
         auto colon = expect(TokenType::Colon);
         if (!colon) return std::unexpected(colon.error());
 
-        auto value = parse_value();
+        auto value = parse_value<Checked>();
         if (!value) return value;
 
-        pairs.push_back(ObjectPair{{key_text.data(), key_text.size()}, *value});
-
-        token = peek();
-        if (!token) return std::unexpected(token.error());
+        pairs_.push_back(ObjectPair{{key_text.data(), key_text.size()}, *value});
+        if constexpr (Checked) key_offsets_.push_back(key_offset);
 
-        if (token->type == TokenType::RightBrace) {
+        const Token& token = peek();
+        if (token.type == TokenType::RightBrace) {
             consume();
             break;
         }
 
-        if (token->type != TokenType::Comma) {
-            return std::unexpected(Error{ErrorCode::ExpectedComma, token->offset,
+        if (token.type != TokenType::Comma) {
+            return std::unexpected(Error{ErrorCode::ExpectedComma, token.offset,
                                        error_message(ErrorCode::ExpectedComma)});
         }
         consume();
@@ -221,15 +327,28 @@ Result<Node*> Parser::parse_object() {
 
     --depth_;
 
+    if constexpr (Checked) {
+        auto policy = apply_duplicate_policy(base);
+        key_offsets_.resize(base);
+        if (!policy) return std::unexpected(policy.error());
+    }
+
     // Copy to arena
-    ObjectPair* obj = arena_.alloc<ObjectPair>(pairs.size());
-    for (size_t i = 0; i < pairs.size(); ++i) {
-        obj[i] = pairs[i];
+    size_t count = pairs_.size() - base;
+    ObjectPair* obj = arena_.alloc<ObjectPair>(count);
+    if (!obj) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, current_.offset,
+                                   error_message(ErrorCode::OutOfMemory)});
     }
+    std::copy(pairs_.begin() + static_cast<ptrdiff_t>(base), pairs_.end(), obj);
+    pairs_.resize(base);
 
-    Node* node = arena_.alloc<Node>();
-    *node = Node::make_object(obj, pairs.size());
-    return node;
+    return new_node(Node::make_object(obj, count), current_.offset);
 }
 
+template class BasicParser<DefaultPolicy>;
+template class BasicParser<TrustedPolicy>;
+template class BasicParser<StrictPolicy>;
+template class BasicParser<TrustedIntegerPolicy>;
+
 } // namespace json
@@ -0,0 +1,142 @@
+#pragma once
+
+// Internal vectorized scanning kernels shared by the tokenizer and writer.
+// Selected at compile time from the target's instruction set; every kernel
+// has a portable scalar fallback with identical results.
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define JSON_SIMD_NEON 1
+#endif
+
+namespace json::simd {
+
+/// True for bytes that end a clean string run: '"', '\\' and control characters.
+constexpr bool is_string_special(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+/**
+ * Finds the first '"', '\\' or control character (< 0x20).
+ * Returns `size` if the range contains none.
+ */
+inline size_t find_string_special(const char* data, size_t size) {
+    size_t i = 0;
+
+#if defined(JSON_SIMD_AVX2)
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    const __m256i control32 = _mm256_set1_epi8(0x1F);
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote32), _mm256_cmpeq_epi8(v, backslash32)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, control32), v));   // v <= 0x1F
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (mask) return i + static_cast<size_t>(std::countr_zero(mask));
+    }
+#endif
+
+#if defined(JSON_SIMD_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));   // v <= 0x1F
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (mask) return i + static_cast<size_t>(std::countr_zero(mask));
+    }
+#elif defined(JSON_SIMD_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)),
+                                  vcleq_u8(v, control));
+        // Narrow to 4 bits per byte to locate the first hit
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask) return i + static_cast<size_t>(std::countr_zero(mask) >> 2);
+    }
+#endif
+
+    for (; i < size; ++i) {
+        if (is_string_special(static_cast<unsigned char>(data[i]))) return i;
+    }
+    return size;
+}
+
+/**
+ * Finds the first '"', '\\', control character (< 0x20) or non-ASCII byte
+ * (>= 0x80), so that multi-byte UTF-8 sequences can be checked while pure
+ * ASCII runs are skipped a vector at a time.
+ * Returns `size` if the range contains none.
+ */
+inline size_t find_string_special_or_non_ascii(const char* data, size_t size) {
+    size_t i = 0;
+
+#if defined(JSON_SIMD_AVX2)
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    const __m256i control32 = _mm256_set1_epi8(0x1F);
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote32), _mm256_cmpeq_epi8(v, backslash32)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, control32), v));   // v <= 0x1F
+        // The sign bit of each byte marks non-ASCII
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(hit, v)));
+        if (mask) return i + static_cast<size_t>(std::countr_zero(mask));
+    }
+#endif
+
+#if defined(JSON_SIMD_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));   // v <= 0x1F
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(hit, v)));
+        if (mask) return i + static_cast<size_t>(std::countr_zero(mask));
+    }
+#elif defined(JSON_SIMD_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x1F);
+    const uint8x16_t ascii = vdupq_n_u8(0x7F);
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)),
+                                  vorrq_u8(vcleq_u8(v, control), vcgtq_u8(v, ascii)));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask) return i + static_cast<size_t>(std::countr_zero(mask) >> 2);
+    }
+#endif
+
+    for (; i < size; ++i) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if (c >= 0x80 || is_string_special(c)) return i;
+    }
+    return size;
+}
+
+} // namespace json::simd
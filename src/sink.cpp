@@ -0,0 +1,184 @@
+#include "json/sink.hpp"
+#include <algorithm>
+#include <cerrno>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace json {
+
+void Sink::append_slow(const char* data, size_t size) {
+    while (size > 0) {
+        size_t room = static_cast<size_t>(end_ - cur_);
+        if (room == 0) {
+            if (!overflow(size)) return;
+            room = static_cast<size_t>(end_ - cur_);
+        }
+        size_t chunk = std::min(room, size);
+        std::memcpy(cur_, data, chunk);
+        cur_ += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void Sink::fill(char c, size_t count) {
+    while (count > 0) {
+        size_t room = static_cast<size_t>(end_ - cur_);
+        if (room == 0) {
+            if (!overflow(count)) return;
+            room = static_cast<size_t>(end_ - cur_);
+        }
+        size_t chunk = std::min(room, count);
+        std::memset(cur_, c, chunk);
+        cur_ += chunk;
+        count -= chunk;
+    }
+}
+
+bool StringSink::overflow(size_t size) {
+    size_t used = cur_ ? static_cast<size_t>(cur_ - out_.data()) : size_;
+    size_t capacity = std::max({out_.size() * 2, used + size, size_t{256}});
+    out_.resize(capacity);
+    cur_ = out_.data() + used;
+    end_ = out_.data() + out_.size();
+    return true;
+}
+
+bool StringSink::sync() {
+    if (cur_) {
+        size_ = static_cast<size_t>(cur_ - out_.data());
+        out_.resize(size_);
+        cur_ = end_ = nullptr;
+    }
+    return true;
+}
+
+ArenaSink::ArenaSink(Arena& arena, size_t capacity) : arena_(arena) {
+    begin_ = arena_.alloc<char>(std::max<size_t>(capacity, 1));
+    if (!begin_) {
+        failed_ = true;
+        return;
+    }
+    cur_ = begin_;
+    end_ = begin_ + std::max<size_t>(capacity, 1);
+}
+
+bool ArenaSink::overflow(size_t size) {
+    if (failed_) return false;
+    size_t used = static_cast<size_t>(cur_ - begin_);
+    size_t capacity = std::max(used * 2, used + size);
+    char* grown = arena_.alloc<char>(capacity);
+    if (!grown) {
+        failed_ = true;
+        return false;
+    }
+    if (used) std::memcpy(grown, begin_, used);
+    begin_ = grown;
+    cur_ = grown + used;
+    end_ = grown + capacity;
+    return true;
+}
+
+BufferedSink::BufferedSink(size_t buffer_size)
+    : capacity_(std::max(buffer_size, MinBufferSize)) {
+    buffer_ = std::make_unique<char[]>(capacity_);
+    cur_ = buffer_.get();
+    end_ = cur_ + capacity_;
+}
+
+bool BufferedSink::overflow(size_t) {
+    return sync();
+}
+
+bool BufferedSink::sync() {
+    if (failed_) return false;
+    size_t size = static_cast<size_t>(cur_ - buffer_.get());
+    cur_ = buffer_.get();
+    if (size > 0 && !deliver(buffer_.get(), size)) {
+        failed_ = true;
+        // Keep discarding output into the buffer
+        return false;
+    }
+    return true;
+}
+
+bool FileSink::deliver(const char* data, size_t size) {
+    return std::fwrite(data, 1, size, file_) == size;
+}
+
+bool FdSink::deliver(const char* data, size_t size) {
+    while (size > 0) {
+#if defined(_WIN32)
+        int written = ::_write(fd_, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+#else
+        ssize_t written = ::write(fd_, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool write_gather(int fd, std::span<const std::string> pieces) {
+#if defined(_WIN32)
+    for (const auto& piece : pieces) {
+        const char* data = piece.data();
+        size_t size = piece.size();
+        while (size > 0) {
+            int written = ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+            if (written < 0) return false;
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+    return true;
+#else
+#if defined(IOV_MAX)
+    constexpr size_t MaxBuffers = IOV_MAX;
+#else
+    constexpr size_t MaxBuffers = 16;
+#endif
+    iovec vectors[MaxBuffers < 1024 ? MaxBuffers : 1024];
+    size_t index = 0;
+    size_t offset = 0;     // Bytes of pieces[index] already written
+    while (index < pieces.size()) {
+        int count = 0;
+        for (size_t i = index; i < pieces.size() && count < static_cast<int>(std::size(vectors)); ++i) {
+            size_t skip = i == index ? offset : 0;
+            if (pieces[i].size() == skip) continue;
+            vectors[count].iov_base = const_cast<char*>(pieces[i].data() + skip);
+            vectors[count].iov_len = pieces[i].size() - skip;
+            ++count;
+        }
+        if (count == 0) return true;
+
+        ssize_t written = ::writev(fd, vectors, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        // Advance past fully written pieces
+        auto remaining = static_cast<size_t>(written);
+        while (index < pieces.size() && remaining >= pieces[index].size() - offset) {
+            remaining -= pieces[index].size() - offset;
+            offset = 0;
+            ++index;
+        }
+        offset += remaining;
+    }
+    return true;
+#endif
+}
+
+} // namespace json
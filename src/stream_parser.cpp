@@ -0,0 +1,544 @@
+#include "json/stream_parser.hpp"
+#include "simd.hpp"
+#include "unicode.hpp"
+#include <charconv>
+#include <cstring>
+#include <memory>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace json {
+
+namespace {
+
+constexpr bool is_whitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+constexpr bool is_number_char(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+constexpr bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Checks the JSON number grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+bool is_valid_number(std::string_view text) {
+    size_t i = 0;
+    size_t n = text.size();
+    if (i < n && text[i] == '-') ++i;
+    if (i == n || !is_digit(text[i])) return false;
+    if (text[i] == '0') {
+        ++i;
+    } else {
+        while (i < n && is_digit(text[i])) ++i;
+    }
+    if (i < n && text[i] == '.') {
+        if (++i == n || !is_digit(text[i])) return false;
+        while (i < n && is_digit(text[i])) ++i;
+    }
+    if (i < n && (text[i] == 'e' || text[i] == 'E')) {
+        ++i;
+        if (i < n && (text[i] == '+' || text[i] == '-')) ++i;
+        if (i == n || !is_digit(text[i])) return false;
+        while (i < n && is_digit(text[i])) ++i;
+    }
+    return i == n;
+}
+
+} // namespace
+
+Result<void> StreamParser::feed(std::span<const char> chunk) {
+    if (error_ != ErrorCode::None) {
+        return std::unexpected(Error{error_, error_offset_, error_message_});
+    }
+
+    const char* data = chunk.data();
+    size_t size = chunk.size();
+    size_t pos = 0;
+    while (pos < size) {
+        switch (state_) {
+            case State::String: {
+                auto next = parse_string(data, pos, size);
+                if (!next) return std::unexpected(next.error());
+                pos = *next;
+                break;
+            }
+
+            case State::Number: {
+                size_t end = pos;
+                while (end < size && is_number_char(data[end])) ++end;
+                if (end == size) {
+                    // May continue in the next chunk
+                    token_.append(data + pos, end - pos);
+                    direct_ = false;
+                    pos = end;
+                    break;
+                }
+                std::string_view text(data + pos, end - pos);
+                if (!direct_) {
+                    token_.append(text);
+                    text = token_;
+                }
+                pos = end;
+                if (auto ok = parse_number(text); !ok) return ok;
+                break;
+            }
+
+            case State::Literal: {
+                if (data[pos] != literal_[literal_pos_]) {
+                    return fail(ErrorCode::InvalidToken, token_start_);
+                }
+                ++pos;
+                if (++literal_pos_ < literal_.size()) break;
+
+                bool ok = literal_[0] == 'n' ? handler_.on_null() : handler_.on_bool(literal_[0] == 't');
+                if (!ok) return fail(ErrorCode::Cancelled, token_start_);
+                if (auto done = complete_value(); !done) return done;
+                break;
+            }
+
+            default: {
+                char c = data[pos];
+                if (is_whitespace(c)) {
+                    ++pos;
+                    break;
+                }
+
+                size_t at = offset_ + pos;
+                Result<void> ok;
+                switch (state_) {
+                    case State::FirstValue:
+                        ok = c == ']' ? close(false, at) : begin_value(c, at);
+                        break;
+
+                    case State::AfterRoot:
+                        if (!multiple_) return fail(ErrorCode::UnexpectedToken, at);
+                        ok = begin_value(c, at);
+                        break;
+
+                    case State::FirstKey:
+                    case State::Key:
+                        if (c == '"') {
+                            in_key_ = true;
+                            direct_ = true;
+                            escape_ = Escape::None;
+                            token_.clear();
+                            token_start_ = at;
+                            state_ = State::String;
+                        } else if (c == '}' && state_ == State::FirstKey) {
+                            ok = close(true, at);
+                        } else {
+                            return fail(ErrorCode::UnexpectedToken, at);
+                        }
+                        break;
+
+                    case State::Colon:
+                        if (c != ':') return fail(ErrorCode::ExpectedColon, at);
+                        state_ = State::Value;
+                        break;
+
+                    case State::CommaOrEnd:
+                        if (c == ',') {
+                            state_ = objects_[depth_ - 1] ? State::Key : State::Value;
+                        } else if (c == ']' || c == '}') {
+                            ok = close(c == '}', at);
+                        } else {
+                            return fail(ErrorCode::ExpectedComma, at);
+                        }
+                        break;
+
+                    default:
+                        ok = begin_value(c, at);
+                        break;
+                }
+                if (!ok) return ok;
+                // Numbers are scanned from their first character
+                if (state_ != State::Number) ++pos;
+                break;
+            }
+        }
+    }
+
+    offset_ += size;
+    return {};
+}
+
+Result<void> StreamParser::finish() {
+    if (error_ != ErrorCode::None) {
+        return std::unexpected(Error{error_, error_offset_, error_message_});
+    }
+    if (state_ == State::Number) {
+        if (auto ok = parse_number(token_); !ok) return ok;
+    }
+    if (state_ == State::AfterRoot || (multiple_ && state_ == State::Value && depth_ == 0)) {
+        return {};
+    }
+    return fail(ErrorCode::UnexpectedEOF, offset_);
+}
+
+void StreamParser::reset() {
+    state_ = State::Value;
+    escape_ = Escape::None;
+    depth_ = 0;
+    offset_ = 0;
+    documents_ = 0;
+    high_surrogate_ = 0;
+    token_.clear();
+    error_ = ErrorCode::None;
+}
+
+Result<size_t> StreamParser::parse_string(const char* data, size_t pos, size_t size) {
+    while (pos < size) {
+        if (escape_ != Escape::None) {
+            if (auto ok = parse_escape(data[pos], offset_ + pos); !ok) {
+                return std::unexpected(ok.error());
+            }
+            ++pos;
+            continue;
+        }
+
+        // Skip the clean run up to the next quote, backslash or control character
+        size_t run = pos;
+        pos += simd::find_string_special(data + pos, size - pos);
+        if (pos == size) {
+            token_.append(data + run, pos - run);
+            direct_ = false;
+            break;
+        }
+
+        char c = data[pos];
+        if (c == '"') {
+            // Report straight from the chunk when nothing had to be copied
+            std::string_view text(data + run, pos - run);
+            if (!direct_) {
+                token_.append(text);
+                text = token_;
+            }
+            bool ok = in_key_ ? handler_.on_key(text) : handler_.on_string(text);
+            if (!ok) return std::unexpected(fail(ErrorCode::Cancelled, token_start_).error());
+            if (in_key_) {
+                state_ = State::Colon;
+            } else if (auto done = complete_value(); !done) {
+                return std::unexpected(done.error());
+            }
+            return pos + 1;
+        }
+
+        token_.append(data + run, pos - run);
+        direct_ = false;
+        if (c == '\\') {
+            escape_ = Escape::Backslash;
+        } else {
+            // Raw control characters are accepted, as by the DOM tokenizer
+            token_.push_back(c);
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+Result<void> StreamParser::parse_escape(char c, size_t offset) {
+    switch (escape_) {
+        case Escape::Backslash:
+            switch (c) {
+                case '"':  token_.push_back('"'); break;
+                case '\\': token_.push_back('\\'); break;
+                case '/':  token_.push_back('/'); break;
+                case 'b':  token_.push_back('\b'); break;
+                case 'f':  token_.push_back('\f'); break;
+                case 'n':  token_.push_back('\n'); break;
+                case 'r':  token_.push_back('\r'); break;
+                case 't':  token_.push_back('\t'); break;
+                case 'u':
+                    escape_ = Escape::Hex;
+                    hex_value_ = 0;
+                    hex_digits_ = 0;
+                    return {};
+                default:
+                    return fail(ErrorCode::InvalidEscape, offset, "Unknown escape sequence");
+            }
+            escape_ = Escape::None;
+            return {};
+
+        case Escape::Hex: {
+            int digit = unicode::hex_value(c);
+            if (digit < 0) {
+                return fail(ErrorCode::InvalidEscape, offset, "Invalid unicode escape sequence");
+            }
+            hex_value_ = (hex_value_ << 4) | static_cast<uint32_t>(digit);
+            if (++hex_digits_ < 4) return {};
+
+            uint32_t codepoint = hex_value_;
+            if (high_surrogate_) {
+                if (codepoint < 0xDC00 || codepoint > 0xDFFF) {
+                    return fail(ErrorCode::InvalidEscape, offset, "Invalid low surrogate");
+                }
+                codepoint = 0x10000 + ((high_surrogate_ - 0xD800) << 10) + (codepoint - 0xDC00);
+                high_surrogate_ = 0;
+            } else if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                high_surrogate_ = codepoint;
+                escape_ = Escape::LowBackslash;
+                return {};
+            }
+
+            char utf8[4];
+            token_.append(utf8, unicode::encode_utf8(static_cast<int>(codepoint), utf8));
+            escape_ = Escape::None;
+            return {};
+        }
+
+        case Escape::LowBackslash:
+            if (c != '\\') return fail(ErrorCode::InvalidEscape, offset, "Missing low surrogate");
+            escape_ = Escape::LowU;
+            return {};
+
+        case Escape::LowU:
+            if (c != 'u') return fail(ErrorCode::InvalidEscape, offset, "Missing low surrogate");
+            escape_ = Escape::Hex;
+            hex_value_ = 0;
+            hex_digits_ = 0;
+            return {};
+
+        case Escape::None:
+            break;
+    }
+    return {};
+}
+
+Result<void> StreamParser::parse_number(std::string_view text) {
+    double value = 0;
+    if (!is_valid_number(text) ||
+        std::from_chars(text.data(), text.data() + text.size(), value).ec != std::errc{}) {
+        return fail(ErrorCode::InvalidNumber, token_start_);
+    }
+    if (!handler_.on_number(value)) return fail(ErrorCode::Cancelled, token_start_);
+    return complete_value();
+}
+
+Result<void> StreamParser::begin_value(char c, size_t offset) {
+    token_start_ = offset;
+    switch (c) {
+        case '{':
+        case '[': {
+            if (depth_ == MaxDepth) return fail(ErrorCode::TooDeep, offset);
+            bool object = c == '{';
+            objects_[depth_++] = object;
+            bool ok = object ? handler_.on_begin_object() : handler_.on_begin_array();
+            if (!ok) return fail(ErrorCode::Cancelled, offset);
+            state_ = object ? State::FirstKey : State::FirstValue;
+            return {};
+        }
+
+        case '"':
+            in_key_ = false;
+            direct_ = true;
+            escape_ = Escape::None;
+            token_.clear();
+            state_ = State::String;
+            return {};
+
+        case 't': literal_ = "true"; break;
+        case 'f': literal_ = "false"; break;
+        case 'n': literal_ = "null"; break;
+
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            direct_ = true;
+            token_.clear();
+            state_ = State::Number;
+            return {};
+
+        case ']':
+        case '}':
+        case ',':
+        case ':':
+            return fail(ErrorCode::ExpectedValue, offset);
+
+        default:
+            return fail(ErrorCode::InvalidToken, offset);
+    }
+
+    literal_pos_ = 1;
+    state_ = State::Literal;
+    return {};
+}
+
+Result<void> StreamParser::complete_value() {
+    if (depth_ > 0) {
+        state_ = State::CommaOrEnd;
+        return {};
+    }
+    ++documents_;
+    state_ = State::AfterRoot;
+    if (!handler_.on_document_end()) return fail(ErrorCode::Cancelled, offset_);
+    return {};
+}
+
+Result<void> StreamParser::close(bool object, size_t offset) {
+    if (depth_ == 0 || objects_[depth_ - 1] != object) {
+        return fail(ErrorCode::UnexpectedToken, offset);
+    }
+    --depth_;
+    bool ok = object ? handler_.on_end_object() : handler_.on_end_array();
+    if (!ok) return fail(ErrorCode::Cancelled, offset);
+    return complete_value();
+}
+
+Result<void> StreamParser::fail(ErrorCode code, size_t offset, std::string_view message) {
+    error_ = code;
+    error_offset_ = offset;
+    error_message_ = message.empty() ? error_message(code) : message;
+    return std::unexpected(Error{error_, error_offset_, error_message_});
+}
+
+bool DomBuilder::on_string(std::string_view str) {
+    StringView copy_view;
+    if (!copy(str, copy_view)) return false;
+    return add(Node::make_string(copy_view.data, copy_view.size));
+}
+
+bool DomBuilder::on_key(std::string_view key) {
+    StringView copy_view;
+    if (!copy(key, copy_view)) return false;
+    keys_.push_back(copy_view);
+    return true;
+}
+
+bool DomBuilder::on_begin_object() {
+    frames_.push_back(Frame{values_.size(), keys_.size()});
+    return true;
+}
+
+bool DomBuilder::on_end_object() {
+    Frame frame = frames_.back();
+    frames_.pop_back();
+    size_t count = values_.size() - frame.values;
+    ObjectPair* pairs = nullptr;
+    if (count > 0) {
+        pairs = arena_.alloc<ObjectPair>(count);
+        if (!pairs) {
+            out_of_memory_ = true;
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            pairs[i] = ObjectPair{keys_[frame.keys + i], values_[frame.values + i]};
+        }
+    }
+    values_.resize(frame.values);
+    keys_.resize(frame.keys);
+    return add(Node::make_object(pairs, count));
+}
+
+bool DomBuilder::on_begin_array() {
+    frames_.push_back(Frame{values_.size(), keys_.size()});
+    return true;
+}
+
+bool DomBuilder::on_end_array() {
+    Frame frame = frames_.back();
+    frames_.pop_back();
+    size_t count = values_.size() - frame.values;
+    Node** elements = nullptr;
+    if (count > 0) {
+        elements = arena_.alloc<Node*>(count);
+        if (!elements) {
+            out_of_memory_ = true;
+            return false;
+        }
+        std::memcpy(elements, values_.data() + frame.values, count * sizeof(Node*));
+    }
+    values_.resize(frame.values);
+    return add(Node::make_array(elements, count));
+}
+
+bool DomBuilder::add(const Node& node) {
+    Node* copy_node = arena_.alloc<Node>();
+    if (!copy_node) {
+        out_of_memory_ = true;
+        return false;
+    }
+    *copy_node = node;
+    if (frames_.empty()) {
+        root_ = copy_node;
+    } else {
+        values_.push_back(copy_node);
+    }
+    return true;
+}
+
+bool DomBuilder::copy(std::string_view str, StringView& out) {
+    if (str.empty()) {
+        out = StringView{"", 0};
+        return true;
+    }
+    char* buffer = arena_.alloc<char>(str.size());
+    if (!buffer) {
+        out_of_memory_ = true;
+        return false;
+    }
+    std::memcpy(buffer, str.data(), str.size());
+    out = StringView{buffer, str.size()};
+    return true;
+}
+
+Result<void> parse_stream(std::istream& in, EventHandler& handler,
+                          bool multiple_documents, size_t chunk_size) {
+    chunk_size = std::max<size_t>(chunk_size, 1);
+    auto buffer = std::make_unique<char[]>(chunk_size);
+    StreamParser parser(handler, multiple_documents);
+    while (in) {
+        in.read(buffer.get(), static_cast<std::streamsize>(chunk_size));
+        auto count = static_cast<size_t>(in.gcount());
+        if (count == 0) continue;
+        if (auto ok = parser.feed(std::span<const char>(buffer.get(), count)); !ok) return ok;
+    }
+    if (in.bad()) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, parser.offset(), "Failed to read input"});
+    }
+    return parser.finish();
+}
+
+Result<void> parse_stream(int fd, EventHandler& handler,
+                          bool multiple_documents, size_t chunk_size) {
+    chunk_size = std::max<size_t>(chunk_size, 1);
+    auto buffer = std::make_unique<char[]>(chunk_size);
+    StreamParser parser(handler, multiple_documents);
+    while (true) {
+#if defined(_WIN32)
+        int count = ::_read(fd, buffer.get(), static_cast<unsigned>(std::min<size_t>(chunk_size, 1u << 30)));
+#else
+        ssize_t count = ::read(fd, buffer.get(), chunk_size);
+        if (count < 0 && errno == EINTR) continue;
+#endif
+        if (count < 0) {
+            return std::unexpected(Error{ErrorCode::OutOfMemory, parser.offset(), "Failed to read input"});
+        }
+        if (count == 0) break;
+        auto ok = parser.feed(std::span<const char>(buffer.get(), static_cast<size_t>(count)));
+        if (!ok) return ok;
+    }
+    return parser.finish();
+}
+
+Result<Node*> parse_stream(std::istream& in, Arena& arena, size_t chunk_size) {
+    DomBuilder builder(arena);
+    if (auto ok = parse_stream(in, builder, false, chunk_size); !ok) {
+        Error error = ok.error();
+        if (error.code == ErrorCode::Cancelled && builder.out_of_memory()) {
+            return std::unexpected(Error{ErrorCode::OutOfMemory, error.offset,
+                                       error_message(ErrorCode::OutOfMemory)});
+        }
+        return std::unexpected(error);
+    }
+    return builder.root();
+}
+
+} // namespace json
@@ -0,0 +1,162 @@
+#include "json/stream_writer.hpp"
+#include <charconv>
+
+namespace json {
+
+StreamWriter& StreamWriter::begin_object() {
+    ++calls_;
+    open(InObject, '{');
+    return *this;
+}
+
+StreamWriter& StreamWriter::end_object() {
+    ++calls_;
+    close(InObject, '}');
+    return *this;
+}
+
+StreamWriter& StreamWriter::begin_array() {
+    ++calls_;
+    open(InArray, '[');
+    return *this;
+}
+
+StreamWriter& StreamWriter::end_array() {
+    ++calls_;
+    close(InArray, ']');
+    return *this;
+}
+
+StreamWriter& StreamWriter::key(std::string_view name) {
+    ++calls_;
+    if (error_ != ErrorCode::None) return *this;
+    if (depth_ == 0 || !(frames_[depth_ - 1] & InObject) || key_written_) {
+        fail(ErrorCode::UnexpectedToken);
+        return *this;
+    }
+
+    uint8_t& frame = frames_[depth_ - 1];
+    if (frame & HasElements) out_.put(',');
+    frame |= HasElements;
+    if (pretty_) newline_indent(depth_);
+
+    write_string(name, out_);
+    out_.append(pretty_ ? std::string_view(": ") : std::string_view(":"));
+    key_written_ = true;
+    return *this;
+}
+
+StreamWriter& StreamWriter::value(std::nullptr_t) {
+    ++calls_;
+    if (before_value()) out_.append("null");
+    return *this;
+}
+
+StreamWriter& StreamWriter::value(bool flag) {
+    ++calls_;
+    if (before_value()) out_.append(flag ? std::string_view("true") : std::string_view("false"));
+    return *this;
+}
+
+StreamWriter& StreamWriter::value(double number) {
+    ++calls_;
+    if (before_value()) write_number(number, out_);
+    return *this;
+}
+
+StreamWriter& StreamWriter::value(std::string_view str) {
+    ++calls_;
+    if (before_value()) write_string(str, out_);
+    return *this;
+}
+
+StreamWriter& StreamWriter::write_int(int64_t number) {
+    ++calls_;
+    if (before_value()) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+        out_.append(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+    return *this;
+}
+
+StreamWriter& StreamWriter::write_uint(uint64_t number) {
+    ++calls_;
+    if (before_value()) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+        out_.append(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+    return *this;
+}
+
+Result<void> StreamWriter::finish() {
+    bool flushed = out_.flush();
+    if (error_ == ErrorCode::None && (depth_ > 0 || !root_written_)) {
+        error_ = ErrorCode::UnexpectedEOF;
+        error_call_ = calls_;
+    }
+    if (error_ != ErrorCode::None) {
+        return std::unexpected(Error{error_, error_call_, error_message(error_)});
+    }
+    if (!flushed) {
+        return std::unexpected(Error{ErrorCode::OutOfMemory, calls_, "Failed to write output"});
+    }
+    return {};
+}
+
+bool StreamWriter::before_value() {
+    if (error_ != ErrorCode::None) return false;
+
+    if (depth_ == 0) {
+        // A single root value; unclosed containers are reported by finish()
+        if (root_written_) return fail(ErrorCode::UnexpectedToken);
+        root_written_ = true;
+        return true;
+    }
+
+    uint8_t& frame = frames_[depth_ - 1];
+    if (frame & InObject) {
+        if (!key_written_) return fail(ErrorCode::UnexpectedToken);
+        key_written_ = false;
+        return true;
+    }
+
+    if (frame & HasElements) out_.put(',');
+    frame |= HasElements;
+    if (pretty_) newline_indent(depth_);
+    return true;
+}
+
+bool StreamWriter::open(uint8_t kind, char bracket) {
+    if (error_ == ErrorCode::None && depth_ == MaxDepth) return fail(ErrorCode::TooDeep);
+    if (!before_value()) return false;
+    out_.put(bracket);
+    frames_[depth_++] = kind;
+    return true;
+}
+
+bool StreamWriter::close(uint8_t kind, char bracket) {
+    if (error_ != ErrorCode::None) return false;
+    if (depth_ == 0 || (frames_[depth_ - 1] & InObject) != kind || key_written_) {
+        return fail(ErrorCode::UnexpectedToken);
+    }
+
+    bool has_elements = frames_[--depth_] & HasElements;
+    if (pretty_ && has_elements) newline_indent(depth_);
+    out_.put(bracket);
+    return true;
+}
+
+void StreamWriter::newline_indent(size_t depth) {
+    out_.put('\n');
+    out_.fill(' ', depth * static_cast<size_t>(indent_size_));
+}
+
+bool StreamWriter::fail(ErrorCode code) {
+    error_ = code;
+    error_call_ = calls_ - 1;
+    return false;
+}
+
+} // namespace json
@@ -1,54 +1,25 @@
 #include "json/tokenizer.hpp"
 #include "json/arena.hpp"
+#include "simd.hpp"
+#include "unicode.hpp"
 #include <cctype>
 #include <cstring>
 
 namespace json {
 
-// Helper to convert hex char to int
-constexpr int hex_to_int(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    return -1;
-}
-
 // Helper to decode \uXXXX escape sequence
 constexpr int decode_unicode_escape(const char* ptr) {
     int val = 0;
     for (int i = 0; i < 4; ++i) {
-        int h = hex_to_int(ptr[i]);
+        int h = unicode::hex_value(ptr[i]);
         if (h < 0) return -1;
         val = (val << 4) | h;
     }
     return val;
 }
 
-// Helper to encode UTF-8 from codepoint
-constexpr size_t encode_utf8(int codepoint, char* out) {
-    if (codepoint < 0x80) {
-        out[0] = static_cast<char>(codepoint);
-        return 1;
-    } else if (codepoint < 0x800) {
-        out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
-        out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
-        return 2;
-    } else if (codepoint < 0x10000) {
-        out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
-        out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
-        out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
-        return 3;
-    } else if (codepoint < 0x110000) {
-        out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
-        out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
-        out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
-        out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
-        return 4;
-    }
-    return 0;
-}
-
-void Tokenizer::skip_whitespace() {
+template <typename Policy>
+void BasicTokenizer<Policy>::skip_whitespace() {
     while (pos_ < input_.size()) {
         char c = input_[pos_];
         if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
@@ -59,7 +30,8 @@ void Tokenizer::skip_whitespace() {
     }
 }
 
-Result<Token> Tokenizer::next() {
+template <typename Policy>
+Result<Token> BasicTokenizer<Policy>::next() {
     skip_whitespace();
 
     if (at_end()) {
@@ -90,16 +62,72 @@ Result<Token> Tokenizer::next() {
     }
 }
 
-Result<Token> Tokenizer::read_string() {
+template <typename Policy>
+void BasicTokenizer<Policy>::fill(TokenBlock& block) {
+    block.size = 0;
+    block.strings.clear();
+    while (block.size < TokenBlock::Capacity) {
+        auto token = next();
+        if (!token) [[unlikely]] {
+            // Room is left for the marker: the loop only runs below Capacity
+            block.failed = true;
+            block.error = token.error();
+            block.tokens[block.size++] = PackedToken{0, TokenType::Invalid, 0, block.error.offset};
+            return;
+        }
+
+        PackedToken& packed = block.tokens[block.size++];
+        packed.type = token->type;
+        packed.flags = token->verbatim ? PackedToken::Verbatim : 0;
+        packed.offset = token->offset;
+
+        // Punctuation and keyword texts equal their input range; strings
+        // decoded into the arena (or too long to pack) go to the side table
+        bool in_input = token->type != TokenType::String ||
+                        token->text.data() == input_.data() + token->offset;
+        if (in_input && token->text.size() <= UINT32_MAX) [[likely]] {
+            packed.data = static_cast<uint32_t>(token->text.size());
+        } else {
+            packed.data = static_cast<uint32_t>(block.strings.size());
+            packed.flags |= PackedToken::Side;
+            block.strings.push_back(token->text);
+        }
+
+        if (token->type == TokenType::End) return;
+    }
+}
+
+template <typename Policy>
+Result<Token> BasicTokenizer<Policy>::read_string() {
     size_t start = pos_;
     ++pos_; // Skip opening quote
 
-    // First pass: check if there are any escape sequences
+    // With validation the scan also stops at non-ASCII bytes, whose UTF-8
+    // sequences are checked one at a time
+    const bool validate = validate_utf8();
+    auto scan = [this, validate](size_t from) {
+        const char* data = input_.data() + from;
+        size_t size = input_.size() - from;
+        return from + (validate ? simd::find_string_special_or_non_ascii(data, size)
+                                : simd::find_string_special(data, size));
+    };
+
+    // Common case: the first special byte is the closing quote, so the
+    // string needs no unescaping and can be written back verbatim
+    size_t scan_pos = scan(pos_);
+    if (scan_pos < input_.size() && input_[scan_pos] == '"') {
+        if (too_long(scan_pos - pos_)) return string_too_long(start);
+        std::string_view text(input_.data() + start, scan_pos + 1 - start);
+        pos_ = scan_pos + 1; // Skip closing quote
+        return Token{TokenType::String, text, start, true};
+    }
+
+    // Otherwise check if there are any escape sequences
     bool has_escapes = false;
-    size_t scan_pos = pos_;
+    bool has_controls = false;
     
     while (scan_pos < input_.size()) {
-        char c = input_[scan_pos];
+        auto c = static_cast<unsigned char>(input_[scan_pos]);
         
         if (c == '"') {
             break;
@@ -113,9 +141,25 @@ Result<Token> Tokenizer::read_string() {
                                            error_message(ErrorCode::InvalidEscape)});
             }
             ++scan_pos;
-        } else {
+        } else if (c < 0x20) {
+            if (validate) {
+                return std::unexpected(Error{ErrorCode::InvalidString, scan_pos,
+                                           "Unescaped control character"});
+            }
+            has_controls = true;
             ++scan_pos;
+        } else {
+            // Non-ASCII: only reached when validating
+            size_t length = unicode::utf8_sequence_length(input_.data() + scan_pos,
+                                                          input_.size() - scan_pos);
+            if (length == 0) {
+                return std::unexpected(Error{ErrorCode::InvalidString, scan_pos,
+                                           "Invalid UTF-8 sequence"});
+            }
+            scan_pos += length;
         }
+        // Skip the clean run up to the next byte that needs a look
+        scan_pos = scan(scan_pos);
     }
 
     if (scan_pos >= input_.size()) {
@@ -125,20 +169,39 @@ Result<Token> Tokenizer::read_string() {
 
     // Fast path: no escapes, zero-copy string
     if (!has_escapes) {
-        size_t content_size = scan_pos - pos_;
+        if (too_long(scan_pos - pos_)) return string_too_long(start);
         std::string_view text(input_.data() + start, scan_pos + 1 - start);
         pos_ = scan_pos + 1; // Skip closing quote
-        return Token{TokenType::String, text, start};
+        return Token{TokenType::String, text, start, !has_controls};
     }
 
-    // Slow path: process escapes and allocate new buffer
-    // Allocate maximum needed size (worst case: no escapes reduce size)
+    // Slow path: process escapes. Without an arena the escapes are only
+    // checked: nothing is written and the token keeps the raw source text
+    return arena_ ? unescape_string<true>(start, scan_pos) : unescape_string<false>(start, scan_pos);
+}
+
+template <typename Policy>
+template <bool Decode>
+Result<Token> BasicTokenizer<Policy>::unescape_string(size_t start, size_t scan_pos) {
+    // Unescaping never grows the text: every escape sequence is at least as
+    // long as the UTF-8 it decodes to, so the source length is an upper bound
     size_t content_size = scan_pos - pos_;
-    char* buffer = arena_->alloc<char>(content_size * 4 + 3); // Max UTF-8 expansion + quotes + null
-    char* write_ptr = buffer;
+    char* buffer = nullptr;
+    if constexpr (Decode) {
+        buffer = arena_->alloc<char>(content_size + 3); // Content + quotes + null
+        if (!buffer) {
+            return std::unexpected(Error{ErrorCode::OutOfMemory, start,
+                                       error_message(ErrorCode::OutOfMemory)});
+        }
+    }
+    size_t written = 0;
+    auto put = [&](char ch) {
+        if constexpr (Decode) buffer[written] = ch;
+        ++written;
+    };
     
     // Add opening quote to buffer
-    *write_ptr++ = '"';
+    put('"');
     
     size_t read_pos = pos_;
     while (read_pos < scan_pos) {
@@ -153,14 +216,14 @@ Result<Token> Tokenizer::read_string() {
             
             char escape = input_[read_pos];
             switch (escape) {
-                case '"':  *write_ptr++ = '"'; break;
-                case '\\': *write_ptr++ = '\\'; break;
-                case '/':  *write_ptr++ = '/'; break;
-                case 'b':  *write_ptr++ = '\b'; break;
-                case 'f':  *write_ptr++ = '\f'; break;
-                case 'n':  *write_ptr++ = '\n'; break;
-                case 'r':  *write_ptr++ = '\r'; break;
-                case 't':  *write_ptr++ = '\t'; break;
+                case '"':  put('"'); break;
+                case '\\': put('\\'); break;
+                case '/':  put('/'); break;
+                case 'b':  put('\b'); break;
+                case 'f':  put('\f'); break;
+                case 'n':  put('\n'); break;
+                case 'r':  put('\r'); break;
+                case 't':  put('\t'); break;
                 case 'u': {
                     // Unicode escape: \uXXXX
                     ++read_pos;
@@ -192,16 +255,21 @@ Result<Token> Tokenizer::read_string() {
                         }
                         codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
                         read_pos += 3; // Will be incremented at end
+                    } else if (validate_utf8() && codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                        // Would decode to ill-formed UTF-8
+                        return std::unexpected(Error{ErrorCode::InvalidEscape, read_pos,
+                                                   "Unpaired low surrogate"});
                     } else {
                         read_pos += 3; // Will be incremented at end
                     }
                     
-                    size_t utf8_len = encode_utf8(codepoint, write_ptr);
+                    char utf8[4];
+                    size_t utf8_len = unicode::encode_utf8(codepoint, utf8);
                     if (utf8_len == 0) {
                         return std::unexpected(Error{ErrorCode::InvalidEscape, read_pos,
                                                    "Invalid codepoint"});
                     }
-                    write_ptr += utf8_len;
+                    for (size_t i = 0; i < utf8_len; ++i) put(utf8[i]);
                     break;
                 }
                 default:
@@ -210,22 +278,33 @@ Result<Token> Tokenizer::read_string() {
             }
             ++read_pos;
         } else {
-            *write_ptr++ = c;
+            put(c);
             ++read_pos;
         }
     }
     
     // Add closing quote
-    *write_ptr++ = '"';
-    *write_ptr = '\0';
+    put('"');
+    if (too_long(written - 2)) return string_too_long(start);
     
     pos_ = scan_pos + 1; // Skip closing quote in input
     
-    std::string_view processed_text(buffer, write_ptr - buffer);
-    return Token{TokenType::String, processed_text, start};
+    if constexpr (!Decode) {
+        return Token{TokenType::String, std::string_view(input_.data() + start, pos_ - start), start};
+    } else {
+        buffer[written] = '\0';
+        std::string_view processed_text(buffer, written);
+        return Token{TokenType::String, processed_text, start};
+    }
+}
+
+template <typename Policy>
+Result<Token> BasicTokenizer<Policy>::string_too_long(size_t start) const {
+    return std::unexpected(Error{ErrorCode::TooLarge, start, "String too long"});
 }
 
-Result<Token> Tokenizer::read_number() {
+template <typename Policy>
+Result<Token> BasicTokenizer<Policy>::read_number() {
     size_t start = pos_;
 
     if (input_[pos_] == '-') ++pos_;
@@ -275,7 +354,8 @@ Result<Token> Tokenizer::read_number() {
     return Token{TokenType::Number, text, start};
 }
 
-Result<Token> Tokenizer::read_keyword(std::string_view keyword, TokenType type) {
+template <typename Policy>
+Result<Token> BasicTokenizer<Policy>::read_keyword(std::string_view keyword, TokenType type) {
     size_t start = pos_;
     
     for (size_t i = 0; i < keyword.size(); ++i) {
@@ -290,4 +370,9 @@ Result<Token> Tokenizer::read_keyword(std::string_view keyword, TokenType type)
     return Token{type, text, start};
 }
 
+template class BasicTokenizer<DefaultPolicy>;
+template class BasicTokenizer<TrustedPolicy>;
+template class BasicTokenizer<StrictPolicy>;
+template class BasicTokenizer<TrustedIntegerPolicy>;
+
 } // namespace json
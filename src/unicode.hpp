@@ -0,0 +1,82 @@
+#pragma once
+
+// Internal helpers for decoding \uXXXX escapes and checking UTF-8, shared
+// by the tokenizer and the streaming parser.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace json::unicode {
+
+/// Value of a hexadecimal digit, or -1 for any other character.
+constexpr int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/// Encodes a code point as UTF-8. Returns the length, or 0 if out of range.
+constexpr size_t encode_utf8(int codepoint, char* out) {
+    if (codepoint < 0x80) {
+        out[0] = static_cast<char>(codepoint);
+        return 1;
+    } else if (codepoint < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 2;
+    } else if (codepoint < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 3;
+    } else if (codepoint < 0x110000) {
+        out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+/// Sequence length and allowed second-byte range for a UTF-8 lead byte.
+struct Utf8Lead {
+    uint8_t length;     ///< 0 for bytes that cannot start a sequence
+    uint8_t low;
+    uint8_t high;
+};
+
+/// Lead byte table after Unicode Table 3-7 (well-formed UTF-8 byte sequences).
+/// The second-byte ranges exclude overlong forms, surrogates and code points
+/// above U+10FFFF.
+inline constexpr std::array<Utf8Lead, 256> utf8_leads = [] {
+    std::array<Utf8Lead, 256> table{};
+    for (int c = 0; c < 0x80; ++c) table[c] = {1, 0, 0};
+    for (int c = 0xC2; c <= 0xDF; ++c) table[c] = {2, 0x80, 0xBF};
+    for (int c = 0xE0; c <= 0xEF; ++c) table[c] = {3, 0x80, 0xBF};
+    for (int c = 0xF0; c <= 0xF4; ++c) table[c] = {4, 0x80, 0xBF};
+    table[0xE0].low = 0xA0;
+    table[0xED].high = 0x9F;
+    table[0xF0].low = 0x90;
+    table[0xF4].high = 0x8F;
+    return table;
+}();
+
+/// Length of the well-formed UTF-8 sequence at `data`, or 0 if it is
+/// malformed or truncated by `size`.
+constexpr size_t utf8_sequence_length(const char* data, size_t size) {
+    const Utf8Lead& lead = utf8_leads[static_cast<unsigned char>(data[0])];
+    if (lead.length <= 1) return lead.length;
+    if (size < lead.length) return 0;
+
+    auto second = static_cast<unsigned char>(data[1]);
+    if (second < lead.low || second > lead.high) return 0;
+    for (size_t i = 2; i < lead.length; ++i) {
+        if ((static_cast<unsigned char>(data[i]) & 0xC0) != 0x80) return 0;
+    }
+    return lead.length;
+}
+
+} // namespace json::unicode
@@ -0,0 +1,185 @@
+#include "json/validator.hpp"
+#include "keys.hpp"
+#include "number.hpp"
+#include <algorithm>
+#include <charconv>
+
+namespace json {
+
+Result<void> Validator::validate() {
+    enum class State {
+        Value,          ///< Expecting a value
+        FirstValue,     ///< After '[': a value or ']'
+        FirstKey,       ///< After '{': a key or '}'
+        Key,            ///< After ',' in an object
+        CommaOrEnd      ///< After an element
+    };
+
+    if (tok_.size() > options_.max_document_size) {
+        return std::unexpected(Error{ErrorCode::TooLarge, options_.max_document_size,
+                                   error_message(ErrorCode::TooLarge)});
+    }
+
+    bool reject_duplicates = options_.duplicate_keys == DuplicateKeys::Reject;
+    size_t max_depth = std::min(options_.max_depth, MaxDepth);
+    State state = State::Value;
+    size_t depth = 0;
+    keys_.clear();
+    key_bases_.clear();
+
+    while (true) {
+        auto token = tok_.next();
+        if (!token) return std::unexpected(token.error());
+
+        bool completed = false;     // A value (scalar or container) just ended
+        switch (state) {
+            case State::FirstValue:
+                if (token->type == TokenType::RightBracket) {
+                    --depth;
+                    completed = true;
+                    break;
+                }
+                [[fallthrough]];
+
+            case State::Value:
+                switch (token->type) {
+                    case TokenType::Number:
+                        if (auto number = check_number(*token); !number) return number;
+                        [[fallthrough]];
+                    case TokenType::String:
+                    case TokenType::True:
+                    case TokenType::False:
+                    case TokenType::Null:
+                        completed = true;
+                        break;
+
+                    case TokenType::LeftBracket:
+                    case TokenType::LeftBrace:
+                        if (depth == max_depth) {
+                            return std::unexpected(Error{ErrorCode::TooDeep, tok_.position(),
+                                                       error_message(ErrorCode::TooDeep)});
+                        }
+                        objects_[depth++] = token->type == TokenType::LeftBrace;
+                        if (reject_duplicates && token->type == TokenType::LeftBrace) {
+                            key_bases_.push_back(keys_.size());
+                        }
+                        state = token->type == TokenType::LeftBrace ? State::FirstKey : State::FirstValue;
+                        break;
+
+                    default:
+                        return std::unexpected(Error{ErrorCode::ExpectedValue, token->offset,
+                                                   error_message(ErrorCode::ExpectedValue)});
+                }
+                break;
+
+            case State::FirstKey:
+                if (token->type == TokenType::RightBrace) {
+                    --depth;
+                    if (reject_duplicates) key_bases_.pop_back();
+                    completed = true;
+                    break;
+                }
+                [[fallthrough]];
+
+            case State::Key: {
+                if (token->type != TokenType::String) {
+                    return std::unexpected(Error{ErrorCode::UnexpectedToken, token->offset,
+                                               error_message(ErrorCode::UnexpectedToken)});
+                }
+                auto colon = tok_.next();
+                if (!colon) return std::unexpected(colon.error());
+                if (colon->type != TokenType::Colon) {
+                    return std::unexpected(Error{ErrorCode::UnexpectedToken, colon->offset,
+                                               error_message(ErrorCode::UnexpectedToken)});
+                }
+                if (reject_duplicates) {
+                    if (auto added = add_key(*token); !added) return added;
+                }
+                state = State::Value;
+                break;
+            }
+
+            case State::CommaOrEnd: {
+                bool object = objects_[depth - 1];
+                if (token->type == TokenType::Comma) {
+                    state = object ? State::Key : State::Value;
+                } else if (token->type == (object ? TokenType::RightBrace : TokenType::RightBracket)) {
+                    --depth;
+                    if (object && reject_duplicates) {
+                        if (auto unique = check_duplicates(); !unique) return unique;
+                    }
+                    completed = true;
+                } else {
+                    return std::unexpected(Error{ErrorCode::ExpectedComma, token->offset,
+                                               error_message(ErrorCode::ExpectedComma)});
+                }
+                break;
+            }
+        }
+
+        if (!completed) continue;
+        if (depth > 0) {
+            state = State::CommaOrEnd;
+            continue;
+        }
+
+        // Verify we're at end of input
+        auto end = tok_.next();
+        if (!end) return std::unexpected(end.error());
+        if (end->type != TokenType::End) {
+            return std::unexpected(Error{ErrorCode::UnexpectedToken, end->offset,
+                                       error_message(ErrorCode::UnexpectedToken)});
+        }
+        return {};
+    }
+}
+
+Result<void> Validator::check_number(const Token& token) const {
+    // The tokenizer checked the grammar; this rejects what the parser
+    // cannot convert, such as values out of double range
+    double value;
+    auto result = std::from_chars(token.text.data(), token.text.data() + token.text.size(), value);
+    if (result.ec != std::errc{}) {
+        return std::unexpected(Error{ErrorCode::InvalidNumber, token.offset,
+                                   error_message(ErrorCode::InvalidNumber)});
+    }
+    if (options_.number_mode == NumberMode::Integer) {
+        if (auto integer = number::exact_integer(token.text, token.offset); !integer) {
+            return std::unexpected(integer.error());
+        }
+    }
+    return {};
+}
+
+Result<void> Validator::add_key(const Token& token) {
+    // Without an arena the token holds the raw text; keys with escapes are
+    // decoded so that e.g. "a" and "\u0061" compare equal
+    std::string_view key = token.text.substr(1, token.text.size() - 2);
+    if (key.find('\\') != std::string_view::npos) {
+        if (!scratch_) scratch_ = std::make_unique<Arena>(1024);
+        scratch_->reset();
+        Tokenizer decoder(token.text, *scratch_);
+        auto decoded = decoder.next();
+        if (!decoded) return std::unexpected(decoded.error());
+        key = decoded->text.substr(1, decoded->text.size() - 2);
+    }
+    keys_.emplace_back(std::string(key), token.offset);
+    return {};
+}
+
+Result<void> Validator::check_duplicates() {
+    size_t base = key_bases_.back();
+    key_bases_.pop_back();
+    size_t count = keys_.size() - base;
+
+    auto key = [&](size_t i) -> const std::string& { return keys_[base + i].first; };
+    keys::sort_members(order_, count, key);
+    size_t first = keys::first_repeat(order_, count, key);
+    size_t offset = first < count ? keys_[base + first].second : 0;
+    keys_.resize(base);
+    if (first == count) return {};
+    return std::unexpected(Error{ErrorCode::DuplicateKey, offset,
+                               error_message(ErrorCode::DuplicateKey)});
+}
+
+} // namespace json
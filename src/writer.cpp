@@ -1,125 +1,421 @@
 #include "json/writer.hpp"
-#include <format>
+#include "simd.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
 
 namespace json {
 
-std::string Writer::write(const Node* root) {
-    std::string result;
-    result.reserve(1024);
-    write_node(root, result);
-    return result;
-}
+namespace {
 
-void Writer::write(const Node* root, FILE* out) {
-    std::string str = write(root);
-    std::fwrite(str.data(), 1, str.size(), out);
+constexpr char DigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Writes an unsigned integer two digits at a time, right to left
+char* write_integer(uint64_t value, char* out) {
+    char buffer[20];
+    char* p = buffer + sizeof(buffer);
+    while (value >= 100) {
+        p -= 2;
+        std::memcpy(p, DigitPairs + (value % 100) * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        p -= 2;
+        std::memcpy(p, DigitPairs + value * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    size_t length = static_cast<size_t>(buffer + sizeof(buffer) - p);
+    std::memcpy(out, p, length);
+    return out + length;
 }
 
-void Writer::write_node(const Node* node, std::string& out) {
-    if (!node) {
-        out += "null";
-        return;
+// Character following the backslash for bytes that must be escaped, 'u' for
+// \u00XX sequences, and 0 for bytes that are copied as-is
+constexpr auto EscapeTable = [] {
+    struct Table { char data[256]; } table{};
+    for (int c = 0; c < 0x20; ++c) table.data[c] = 'u';
+    table.data['\b'] = 'b';
+    table.data['\f'] = 'f';
+    table.data['\n'] = 'n';
+    table.data['\r'] = 'r';
+    table.data['\t'] = 't';
+    table.data['"'] = '"';
+    table.data['\\'] = '\\';
+    return table;
+}();
+
+constexpr char HexDigits[] = "0123456789abcdef";
+
+// Length of a string literal including quotes and escape sequences
+size_t measure_string(std::string_view str) {
+    size_t size = str.size() + 2;
+    const char* data = str.data();
+    size_t remaining = str.size();
+    while (true) {
+        size_t clean = simd::find_string_special(data, remaining);
+        if (clean == remaining) break;
+        size += EscapeTable.data[static_cast<unsigned char>(data[clean])] == 'u' ? 5 : 1;
+        data += clean + 1;
+        remaining -= clean + 1;
     }
+    return size;
+}
+
+// Number of elements of a non-empty container, 0 for anything else
+size_t element_count(const Node* node) {
+    if (!node) return 0;
+    if (node->type == NodeType::Array) return node->array_val.size;
+    if (node->type == NodeType::Object) return node->object_val.size;
+    return 0;
+}
+
+// Length of a value that is written without descending into it
+size_t measure_scalar(const Node* node) {
+    if (!node) return 4;
 
     switch (node->type) {
         case NodeType::Null:
-            out += "null";
-            break;
-
+            return 4;
         case NodeType::Bool:
-            out += node->bool_val ? "true" : "false";
-            break;
-
-        case NodeType::Number:
-            out += std::format("{}", node->number_val);
-            break;
-
+            return node->bool_val ? 4 : 5;
+        case NodeType::Number: {
+            char buffer[MaxNumberLength];
+            return static_cast<size_t>(format_number(node->number_val, buffer) - buffer);
+        }
         case NodeType::String:
-            write_string(node->string_val.view(), out);
-            break;
+            if (node->has_flag(NodeFlag::Verbatim)) return node->string_val.size + 2;
+            return measure_string(node->string_val.view());
+        case NodeType::Array:
+        case NodeType::Object:
+            return 2;
+    }
+    return 0;
+}
+
+} // namespace
 
-        case NodeType::Array: {
-            out += '[';
-            if (pretty_ && node->array_val.size > 0) {
-                write_newline(out);
-                ++indent_;
+char* format_number(double value, char* out) noexcept {
+    // Integers up to 2^53 are exact in a double: skip the shortest-digits search
+    constexpr double ExactLimit = 9007199254740992.0;
+    if (value > -ExactLimit && value < ExactLimit) {
+        auto integral = static_cast<int64_t>(value);
+        if (static_cast<double>(integral) == value) {
+            uint64_t magnitude = static_cast<uint64_t>(integral);
+            if (integral < 0 || (integral == 0 && std::signbit(value))) {
+                *out++ = '-';
+                magnitude = 0 - magnitude;
             }
+            return write_integer(magnitude, out);
+        }
+    }
+
+    if (!std::isfinite(value)) [[unlikely]] {
+        std::memcpy(out, "null", 4);
+        return out + 4;
+    }
+
+    // Shortest round-trip representation
+    return std::to_chars(out, out + MaxNumberLength, value).ptr;
+}
+
+void write_number(double value, Sink& out) {
+    // Format straight into the sink's window when it has room
+    if (out.available() >= MaxNumberLength) [[likely]] {
+        char* buffer = out.reserve(MaxNumberLength);
+        out.commit(format_number(value, buffer));
+        return;
+    }
+    char buffer[MaxNumberLength];
+    out.append(buffer, static_cast<size_t>(format_number(value, buffer) - buffer));
+}
+
+void write_string(std::string_view str, Sink& out) {
+    out.put('"');
+    const char* data = str.data();
+    size_t size = str.size();
+    while (true) {
+        // Bulk-copy the clean run up to the next byte that needs escaping
+        size_t clean = simd::find_string_special(data, size);
+        out.append(data, clean);
+        if (clean == size) break;
+
+        auto c = static_cast<unsigned char>(data[clean]);
+        char escape = EscapeTable.data[c];
+        if (escape == 'u') {
+            const char sequence[6] = {'\\', 'u', '0', '0', HexDigits[c >> 4], HexDigits[c & 0xF]};
+            out.append(sequence, 6);
+        } else {
+            const char sequence[2] = {'\\', escape};
+            out.append(sequence, 2);
+        }
+        data += clean + 1;
+        size -= clean + 1;
+    }
+    out.put('"');
+}
+
+size_t measure(const Node* root, const WriterOptions& options) {
+    return Writer(options).measure(root);
+}
 
-            for (size_t i = 0; i < node->array_val.size; ++i) {
-                if (pretty_) write_indent(out);
-                write_node(node->array_val.data[i], out);
-                if (i + 1 < node->array_val.size) {
-                    out += ',';
-                }
-                if (pretty_) write_newline(out);
+std::string Writer::write(const Node* root) {
+    size_t size = measure(root);
+    std::string result;
+    result.resize_and_overwrite(size, [&](char* data, size_t) {
+        SpanSink sink(std::span<char>(data, size));
+        write_node(root, sink);
+        return sink.size();
+    });
+    return result;
+}
+
+WriteResult Writer::write(const Node* root, std::span<char> out) {
+    SpanSink sink(out);
+    write_node(root, sink);
+    if (!sink.failed()) return WriteResult{sink.size(), sink.size()};
+    return WriteResult{sink.size(), measure(root)};
+}
+
+size_t Writer::measure(const Node* root) {
+    size_t size = 0;
+    stack_.clear();
+    const Node* node = root;
+    while (true) {
+        size_t count = element_count(node);
+        if (count > 0) {
+            // Brackets and separating commas
+            size += 2 + (count - 1);
+            if (pretty_) {
+                // Newline after the opening bracket and after every element,
+                // one indent per element and one before the closing bracket
+                size_t depth = stack_.size();
+                size_t indent = static_cast<size_t>(indent_size_);
+                size += 1 + count * (1 + (depth + 1) * indent) + depth * indent;
             }
+            stack_.push_back(Frame{node, 0});
+        } else {
+            size += measure_scalar(node);
+        }
 
-            if (pretty_ && node->array_val.size > 0) {
-                --indent_;
-                write_indent(out);
+        // Find the next element, leaving containers that are done
+        node = nullptr;
+        while (!stack_.empty()) {
+            Frame& top = stack_.back();
+            if (top.next == element_count(top.node)) {
+                stack_.pop_back();
+                continue;
+            }
+            if (top.node->type == NodeType::Object) {
+                const ObjectPair& pair = top.node->object_val.data[top.next++];
+                size += measure_string(pair.key.view()) + (pretty_ ? 2 : 1);
+                node = pair.value;
+            } else {
+                node = top.node->array_val.data[top.next++];
             }
-            out += ']';
             break;
         }
+        if (stack_.empty() && !node) return size;
+    }
+}
 
-        case NodeType::Object: {
-            out += '{';
-            if (pretty_ && node->object_val.size > 0) {
-                write_newline(out);
-                ++indent_;
-            }
+bool Writer::write(const Node* root, FILE* out) {
+    FileSink sink(out);
+    return write(root, sink);
+}
 
-            for (size_t i = 0; i < node->object_val.size; ++i) {
-                if (pretty_) write_indent(out);
-                
-                write_string(node->object_val.data[i].key.view(), out);
-                out += pretty_ ? ": " : ":";
-                write_node(node->object_val.data[i].value, out);
-                
-                if (i + 1 < node->object_val.size) {
-                    out += ',';
-                }
-                if (pretty_) write_newline(out);
+bool Writer::write(const Node* root, Sink& out) {
+    write_node(root, out);
+    return out.flush();
+}
+
+void Writer::write_node(const Node* root, Sink& out, size_t depth) {
+    stack_.clear();
+    const Node* node = root;
+    while (true) {
+        if (element_count(node) > 0) {
+            out.put(node->type == NodeType::Object ? '{' : '[');
+            stack_.push_back(Frame{node, 0});
+        } else {
+            write_scalar(node, out);
+        }
+
+        // Find the next element, closing containers that are done
+        node = nullptr;
+        while (!stack_.empty()) {
+            Frame& top = stack_.back();
+            bool is_object = top.node->type == NodeType::Object;
+            if (top.next == element_count(top.node)) {
+                stack_.pop_back();
+                if (pretty_) write_newline_indent(depth + stack_.size(), out);
+                out.put(is_object ? '}' : ']');
+                continue;
             }
 
-            if (pretty_ && node->object_val.size > 0) {
-                --indent_;
-                write_indent(out);
+            if (top.next > 0) out.put(',');
+            if (pretty_) write_newline_indent(depth + stack_.size(), out);
+            if (is_object) {
+                const ObjectPair& pair = top.node->object_val.data[top.next++];
+                write_string(pair.key.view(), out);
+                out.append(pretty_ ? std::string_view(": ") : std::string_view(":"));
+                node = pair.value;
+            } else {
+                node = top.node->array_val.data[top.next++];
             }
-            out += '}';
             break;
         }
+        if (stack_.empty() && !node) return;
+    }
+}
+
+void Writer::write_elements(const Node* container, size_t begin, size_t end,
+                            size_t depth, Sink& out) {
+    bool is_object = container->type == NodeType::Object;
+    for (size_t i = begin; i < end; ++i) {
+        if (i > 0) out.put(',');
+        if (pretty_) write_newline_indent(depth + 1, out);
+        if (is_object) {
+            const ObjectPair& pair = container->object_val.data[i];
+            write_string(pair.key.view(), out);
+            out.append(pretty_ ? std::string_view(": ") : std::string_view(":"));
+            write_node(pair.value, out, depth + 1);
+        } else {
+            write_node(container->array_val.data[i], out, depth + 1);
+        }
     }
 }
 
-void Writer::write_string(std::string_view str, std::string& out) {
-    out += '"';
-    for (char c : str) {
-        switch (c) {
-            case '"':  out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\b': out += "\\b"; break;
-            case '\f': out += "\\f"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default:
-                if (c >= 0x20) {
-                    out += c;
-                } else {
-                    out += std::format("\\u{:04x}", static_cast<unsigned char>(c));
-                }
+std::vector<std::string> Writer::write_chunks(const Node* root, const ParallelOptions& parallel) {
+    unsigned threads = parallel.threads ? parallel.threads : std::thread::hardware_concurrency();
+    size_t min_chunk = std::max<size_t>(parallel.min_chunk_size, 1);
+
+    // Descend through single-element wrappers such as {"items": [...]}
+    std::vector<const Node*> path;
+    const Node* split = root;
+    while (element_count(split) == 1) {
+        path.push_back(split);
+        split = split->type == NodeType::Object ? split->object_val.data[0].value
+                                                : split->array_val.data[0];
+    }
+
+    size_t count = element_count(split);
+    size_t chunks = std::min<size_t>(std::max(threads, 1u), count / min_chunk);
+    if (chunks < 2) {
+        std::vector<std::string> whole(1);
+        whole[0] = write(root);
+        return whole;
+    }
+
+    // Pieces: the text before the first element, each chunk, the text after
+    std::vector<std::string> pieces(chunks + 2);
+    {
+        StringSink prefix(pieces.front());
+        for (size_t depth = 0; depth < path.size(); ++depth) {
+            bool is_object = path[depth]->type == NodeType::Object;
+            prefix.put(is_object ? '{' : '[');
+            if (pretty_) write_newline_indent(depth + 1, prefix);
+            if (is_object) {
+                write_string(path[depth]->object_val.data[0].key.view(), prefix);
+                prefix.append(pretty_ ? std::string_view(": ") : std::string_view(":"));
+            }
         }
+        prefix.put(split->type == NodeType::Object ? '{' : '[');
     }
-    out += '"';
+
+    std::vector<std::jthread> workers;
+    workers.reserve(chunks - 1);
+    auto write_chunk = [&](size_t chunk) {
+        Writer writer(pretty_, indent_size_);
+        StringSink sink(pieces[chunk + 1]);
+        writer.write_elements(split, count * chunk / chunks, count * (chunk + 1) / chunks,
+                              path.size(), sink);
+    };
+    for (size_t chunk = 1; chunk < chunks; ++chunk) workers.emplace_back(write_chunk, chunk);
+    write_chunk(0);
+    workers.clear();
+
+    {
+        StringSink suffix(pieces.back());
+        if (pretty_) write_newline_indent(path.size(), suffix);
+        suffix.put(split->type == NodeType::Object ? '}' : ']');
+        for (size_t depth = path.size(); depth-- > 0;) {
+            if (pretty_) write_newline_indent(depth, suffix);
+            suffix.put(path[depth]->type == NodeType::Object ? '}' : ']');
+        }
+    }
+    return pieces;
+}
+
+std::string Writer::write_parallel(const Node* root, const ParallelOptions& parallel) {
+    std::vector<std::string> pieces = write_chunks(root, parallel);
+    if (pieces.size() == 1) return std::move(pieces[0]);
+
+    size_t size = 0;
+    for (const auto& piece : pieces) size += piece.size();
+    std::string result;
+    result.reserve(size);
+    for (const auto& piece : pieces) result += piece;
+    return result;
+}
+
+bool Writer::write_parallel(const Node* root, Sink& out, const ParallelOptions& parallel) {
+    for (const auto& piece : write_chunks(root, parallel)) out.append(piece);
+    return out.flush();
 }
 
-void Writer::write_indent(std::string& out) {
-    out.append(indent_ * indent_size_, ' ');
+void Writer::write_scalar(const Node* node, Sink& out) {
+    if (!node) {
+        out.append("null");
+        return;
+    }
+
+    switch (node->type) {
+        case NodeType::Null:
+            out.append("null");
+            break;
+
+        case NodeType::Bool:
+            out.append(node->bool_val ? std::string_view("true") : std::string_view("false"));
+            break;
+
+        case NodeType::Number:
+            write_number(node->number_val, out);
+            break;
+
+        case NodeType::String:
+            if (node->has_flag(NodeFlag::Verbatim)) {
+                // Known to need no escaping: copy without scanning
+                out.put('"');
+                out.append(node->string_val.data, node->string_val.size);
+                out.put('"');
+            } else {
+                write_string(node->string_val.view(), out);
+            }
+            break;
+
+        case NodeType::Array:
+            out.append("[]");
+            break;
+
+        case NodeType::Object:
+            out.append("{}");
+            break;
+    }
 }
 
-void Writer::write_newline(std::string& out) {
-    out += '\n';
+void Writer::write_newline_indent(size_t depth, Sink& out) {
+    size_t length = 1 + depth * static_cast<size_t>(indent_size_);
+    if (length > indentation_.size()) [[unlikely]] {
+        indentation_.assign(std::max(length, indentation_.size() * 2), ' ');
+        indentation_[0] = '\n';
+    }
+    out.append(indentation_.data(), length);
 }
 
-} // namespace json
\ No newline at end of file
+} // namespace json
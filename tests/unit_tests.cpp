@@ -1,7 +1,22 @@
 #include <gtest/gtest.h>
 #include "json/api.hpp"
+#include "json/async_loader.hpp"
+#include "json/async_parse.hpp"
 #include "json/builder.hpp"
+#include "json/canonical.hpp"
+#include "json/clone.hpp"
+#include "json/concurrent_arena.hpp"
+#include "json/stream_parser.hpp"
+#include "json/stream_writer.hpp"
+#include "json/writer.hpp"
 #include <string_view> // Penting!
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace json;
 using namespace std::string_view_literals; // Ini solusinya!
@@ -72,4 +87,1021 @@ TEST_F(JsonTest, ErrorHandling) {
     EXPECT_FALSE(res);
     // Sesuaikan ErrorCode dengan yang ada di header kamu
     // EXPECT_EQ(res.error().code, ErrorCode::InvalidString); 
-}
\ No newline at end of file
+}
+// Upstream resource that counts outstanding bytes, used by arena tests
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t outstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(ArenaTest, UpstreamResource) {
+    CountingResource upstream;
+    {
+        Arena arena(1024, &upstream);
+        auto res = parse(R"({"list": [1, 2, 3], "big": [[], {}, "x"]})"sv, arena);
+        ASSERT_TRUE(res);
+        void* large = arena.allocate(4096, 64);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0u);
+        EXPECT_GT(upstream.allocations, 1u);
+    }
+    EXPECT_EQ(upstream.outstanding, 0u);
+}
+
+TEST(ArenaTest, ArenaAsMemoryResource) {
+    Arena arena;
+    ArenaResource resource(arena);
+    std::pmr::vector<int> values(&resource);
+    for (int i = 0; i < 100; ++i) values.push_back(i);
+    EXPECT_EQ(values[99], 99);
+    EXPECT_TRUE(resource.is_equal(ArenaResource(arena)));
+}
+
+TEST(ArenaTest, StatsAndBudget) {
+    Arena arena(4096);
+    auto res = parse(R"([1, "two", {"three": 3}])"sv, arena);
+    ASSERT_TRUE(res);
+
+    ArenaStats stats = arena.stats();
+    EXPECT_GT(stats.allocated, 0u);
+    EXPECT_EQ(stats.reserved, 4096u);
+    EXPECT_EQ(stats.blocks, 1u);
+    EXPECT_LE(stats.allocated + stats.padding, stats.reserved);
+
+    // A document far larger than the budget fails cleanly
+    std::string big = "[";
+    for (int i = 0; i < 10000; ++i) big += "\"value\",";
+    big += "0]";
+
+    arena.reset();
+    arena.set_budget(16 * 1024);
+    auto limited = parse(std::string_view(big), arena);
+    ASSERT_FALSE(limited);
+    EXPECT_EQ(limited.error().code, ErrorCode::OutOfMemory);
+    EXPECT_LE(arena.stats().reserved, 16u * 1024);
+
+    // Blocks are reused after reset instead of growing the reservation
+    arena.reset();
+    arena.set_budget(Arena::Unlimited);
+    ASSERT_TRUE(parse(std::string_view(big), arena));
+    size_t reserved = arena.stats().reserved;
+    arena.reset();
+    ASSERT_TRUE(parse(std::string_view(big), arena));
+    EXPECT_EQ(arena.stats().reserved, reserved);
+}
+
+TEST(ArenaTest, BuildersHonorBudget) {
+    // No room to reserve more and the current block used up
+    Arena arena(4096);
+    arena.set_budget(arena.stats().reserved);
+    while (arena.alloc<char>(16)) {}
+    EXPECT_EQ(make_null(arena), nullptr);
+    EXPECT_EQ(make_string(arena, "text"), nullptr);
+
+    ArrayBuilder array(arena);
+    array.add(nullptr).add(1.0).add("x");
+    EXPECT_TRUE(array.failed());
+    EXPECT_EQ(array.build(), nullptr);
+
+    // A failed nested build fails its parent
+    ObjectBuilder object(arena);
+    object.add("nested", array.build());
+    EXPECT_TRUE(object.failed());
+    EXPECT_EQ(object.build(), nullptr);
+
+    // Running out part way fails the whole container
+    Arena part(4096);
+    part.set_budget(4096);
+    ArrayBuilder many(part);
+    for (int i = 0; i < 1000; ++i) many.add("some text");
+    EXPECT_TRUE(many.failed());
+    EXPECT_EQ(many.build(), nullptr);
+    EXPECT_LE(part.stats().reserved, 4096u);
+
+    arena.set_budget(Arena::Unlimited);
+    ObjectBuilder root(arena);
+    root.add("list", build_array(arena, {1.0, 2.0})).add("empty", ArrayBuilder(arena).build());
+    Node* node = root.build();
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(write(node), R"({"list":[1,2],"empty":[]})");
+}
+
+TEST_F(JsonTest, CloneCompact) {
+    auto res = parse(R"({"name": "cfg", "tags": ["a", "b\n"], "nested": {"on": true, "n": null}, "empty": []})"sv, arena);
+    ASSERT_TRUE(res);
+
+    size_t expected = compact_size(*res);
+    Arena dst;
+    auto copy = clone_compact(*res, dst);
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(write(*copy), write(*res));
+
+    // One packed region of exactly the reported size
+    ArenaStats stats = dst.stats();
+    EXPECT_EQ(stats.allocated, expected);
+    EXPECT_EQ(stats.padding, 0u);
+
+    Arena tiny(256);
+    tiny.set_budget(256);
+    auto failed = clone_compact(*res, tiny);
+    ASSERT_FALSE(failed);
+    EXPECT_EQ(failed.error().code, ErrorCode::OutOfMemory);
+}
+
+TEST(ArenaTest, ConcurrentArenaSharedDocument) {
+    ConcurrentArena shared(16 * 1024);
+    constexpr int Threads = 4;
+    std::vector<Node*> roots(Threads, nullptr);
+    std::vector<uint64_t*> blocks(Threads, nullptr);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < Threads; ++t) {
+        workers.emplace_back([&, t] {
+            // Per-thread Arena drawing blocks from the shared arena
+            Arena local(1024, &shared);
+            auto res = parse(R"({"worker": [1, 2, 3], "name": "w"})"sv, local);
+            if (res) roots[t] = *res;
+
+            uint64_t* values = shared.alloc<uint64_t>(1000);
+            for (uint64_t i = 0; i < 1000; ++i) values[i] = t * 1000 + i;
+            blocks[t] = values;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    // Everything outlives the per-thread arenas and stays intact
+    for (int t = 0; t < Threads; ++t) {
+        ASSERT_NE(roots[t], nullptr);
+        EXPECT_EQ(write(roots[t]), R"({"worker":[1,2,3],"name":"w"})");
+        for (uint64_t i = 0; i < 1000; ++i) {
+            ASSERT_EQ(blocks[t][i], t * 1000 + i);
+        }
+    }
+    EXPECT_GE(shared.chunks(), static_cast<size_t>(Threads));
+    EXPECT_GT(shared.reserved(), 0u);
+}
+
+TEST(ArenaTest, MoveKeepsAllocations) {
+    Arena arena(256);
+    auto res = parse(R"(["moved", [1, 2], {"k": false}])"sv, arena);
+    ASSERT_TRUE(res);
+    size_t reserved = arena.stats().reserved;
+
+    Arena owner(std::move(arena));
+    EXPECT_EQ(owner.stats().reserved, reserved);
+    EXPECT_EQ(arena.stats().reserved, 0u);
+    EXPECT_EQ(write(*res), R"(["moved",[1,2],{"k":false}])");
+
+    // The moved-from arena is still usable
+    EXPECT_NE(arena.alloc<int>(), nullptr);
+
+    owner = std::move(arena);
+    EXPECT_EQ(owner.stats().blocks, 1u);
+}
+
+TEST(DocumentTest, MoveThroughQueue) {
+    std::vector<Document> queue;
+    for (int i = 0; i < 3; ++i) {
+        auto doc = parse_document(R"({"items": [true, null, "s"]})"sv);
+        ASSERT_TRUE(doc);
+        queue.push_back(std::move(*doc));
+    }
+
+    Document last = std::move(queue.back());
+    queue.pop_back();
+    ASSERT_NE(last.root(), nullptr);
+    EXPECT_TRUE(last->is_object());
+    EXPECT_EQ(write(last.root()), R"({"items":[true,null,"s"]})");
+    for (const Document& doc : queue) {
+        EXPECT_EQ(doc->size(), 1u);
+    }
+
+    auto bad = parse_document("[1,"sv);
+    EXPECT_FALSE(bad);
+}
+
+TEST_F(JsonTest, WriteNumbers) {
+    auto format = [](double value) {
+        char buffer[MaxNumberLength];
+        return std::string(buffer, format_number(value, buffer));
+    };
+
+    EXPECT_EQ(format(0.0), "0");
+    EXPECT_EQ(format(-0.0), "-0");
+    EXPECT_EQ(format(42.0), "42");
+    EXPECT_EQ(format(-1234567.0), "-1234567");
+    EXPECT_EQ(format(9007199254740991.0), "9007199254740991");
+    EXPECT_EQ(format(0.1), "0.1");
+    EXPECT_EQ(format(-2.5e-7), "-2.5e-07");
+    EXPECT_EQ(format(1e300), "1e+300");
+    EXPECT_EQ(format(std::numeric_limits<double>::quiet_NaN()), "null");
+    EXPECT_EQ(format(-std::numeric_limits<double>::infinity()), "null");
+
+    // Shortest output must still round-trip exactly
+    for (double value : {0.1 + 0.2, 1.0 / 3.0, 123.456e-300, 1.7976931348623157e308, -5e-324}) {
+        auto res = parse(std::string_view(format(value)), arena);
+        ASSERT_TRUE(res);
+        EXPECT_EQ((*res)->number_val, value);
+    }
+
+    auto doc = parse("[1, 2.5, -3]"sv, arena);
+    ASSERT_TRUE(doc);
+    EXPECT_EQ(write(*doc), "[1,2.5,-3]");
+}
+
+TEST_F(JsonTest, WriteStringEscapes) {
+    EXPECT_EQ(write(make_string(arena, "plain")), R"("plain")");
+    EXPECT_EQ(write(make_string(arena, "q\"b\\s/\b\f\n\r\t")), R"("q\"b\\s/\b\f\n\r\t")");
+    EXPECT_EQ(write(make_string(arena, std::string_view("\x01\x1f", 2))), R"("\u0001\u001f")");
+    EXPECT_EQ(write(make_string(arena, "caf\xc3\xa9")), "\"caf\xc3\xa9\"");
+
+    // Special bytes at every position of long runs exercise the vector and tail paths
+    for (size_t pos = 0; pos < 70; ++pos) {
+        std::string text(70, 'a');
+        text[pos] = '\n';
+        std::string expected = "\"" + text.substr(0, pos) + "\\n" + text.substr(pos + 1) + "\"";
+        EXPECT_EQ(write(make_string(arena, text)), expected) << "position " << pos;
+    }
+}
+
+TEST_F(JsonTest, StreamingSinks) {
+    std::string input = "[";
+    for (int i = 0; i < 200; ++i) input += R"({"id": )" + std::to_string(i) + R"(, "tag": "item\t"},)";
+    input += "null]";
+    auto res = parse(std::string_view(input), arena);
+    ASSERT_TRUE(res);
+    std::string expected = write(*res, true);
+
+    // Small buffer: output arrives in bounded pieces while writing
+    std::string collected;
+    size_t calls = 0;
+    CallbackSink callback([&](const char* data, size_t size) {
+        EXPECT_LE(size, 64u);
+        collected.append(data, size);
+        ++calls;
+        return true;
+    }, 64);
+    EXPECT_TRUE(write(*res, callback, true));
+    EXPECT_EQ(collected, expected);
+    EXPECT_GT(calls, 100u);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        FileSink sink(file, 128);
+        EXPECT_TRUE(write(*res, sink, true));
+    }
+    std::rewind(file);
+    std::string from_file(expected.size() + 1, '\0');
+    from_file.resize(std::fread(from_file.data(), 1, from_file.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(from_file, expected);
+
+    FILE* raw = std::tmpfile();
+    ASSERT_NE(raw, nullptr);
+    {
+        FdSink sink(fileno(raw), 256);
+        EXPECT_TRUE(write(*res, sink));
+    }
+    std::rewind(raw);
+    std::string from_fd(input.size(), '\0');
+    from_fd.resize(std::fread(from_fd.data(), 1, from_fd.size(), raw));
+    std::fclose(raw);
+    EXPECT_EQ(from_fd, write(*res));
+
+    // A destination that refuses output makes the write fail
+    CallbackSink refusing([](const char*, size_t) { return false; }, 64);
+    EXPECT_FALSE(write(*res, refusing));
+    EXPECT_TRUE(refusing.failed());
+}
+
+TEST_F(JsonTest, MeasureMatchesOutput) {
+    auto res = parse(std::string_view(R"({"name": "tab\there", "values": [1, -2.5, 1e300, true, null], "nested": {"empty": [], "obj": {}}, "ctl": "\u0001"})"), arena);
+    ASSERT_TRUE(res);
+
+    for (bool pretty : {false, true}) {
+        WriterOptions options{pretty, 3};
+        Writer writer(options);
+        std::string text = writer.write(*res);
+        EXPECT_EQ(measure(*res, options), text.size());
+        EXPECT_EQ(writer.measure(*res), text.size());
+
+        std::string buffer(text.size(), '\0');
+        WriteResult exact = writer.write(*res, buffer);
+        EXPECT_TRUE(exact.complete());
+        EXPECT_EQ(buffer, text);
+
+        // A short buffer keeps the prefix and reports the size needed
+        std::string small(text.size() / 2, '\0');
+        WriteResult partial = writer.write(*res, small);
+        EXPECT_FALSE(partial.complete());
+        EXPECT_EQ(partial.required, text.size());
+        EXPECT_EQ(small.substr(0, partial.written), text.substr(0, partial.written));
+    }
+}
+
+TEST_F(JsonTest, WriteToCallerMemory) {
+    auto res = parse(std::string_view(R"({"id": 42, "tags": ["a\"b", "c"], "ok": true})"), arena);
+    ASSERT_TRUE(res);
+    std::string expected = write(*res);
+
+    char buffer[128];
+    WriteResult fit = write(*res, std::span<char>(buffer));
+    EXPECT_TRUE(fit.complete());
+    EXPECT_EQ(std::string_view(buffer, fit.written), expected);
+
+    char tiny[8];
+    WriteResult partial = write(*res, std::span<char>(tiny));
+    EXPECT_EQ(partial.written, sizeof(tiny));
+    EXPECT_EQ(partial.required, expected.size());
+
+    Arena out_arena;
+    auto text = write(*res, out_arena, true);
+    ASSERT_TRUE(text);
+    EXPECT_EQ(*text, write(*res, true));
+
+    Arena limited(64);
+    limited.set_budget(64);
+    auto refused = write(*res, limited, true);
+    ASSERT_FALSE(refused);
+    EXPECT_EQ(refused.error().code, ErrorCode::OutOfMemory);
+
+    std::vector<char> bytes;
+    write(*res, std::back_inserter(bytes));
+    EXPECT_EQ(std::string_view(bytes.data(), bytes.size()), expected);
+
+    // Arrays bind to the bounded span overload, never the iterator one
+    char raw[128];
+    WriteResult whole = write(*res, raw);
+    ASSERT_TRUE(whole.complete());
+    EXPECT_EQ(std::string_view(raw, whole.written), expected);
+    char small[4];
+    WriteResult cut = write(*res, small);
+    EXPECT_LE(cut.written, sizeof(small));
+    EXPECT_EQ(cut.required, expected.size());
+
+    // Growable arena sink: starts tiny and doubles
+    ArenaSink sink(out_arena, 4);
+    EXPECT_TRUE(write(*res, sink));
+    EXPECT_EQ(sink.view(), expected);
+}
+
+TEST_F(JsonTest, StreamWriterMatchesWriter) {
+    auto res = parse(std::string_view(R"({"id": 42, "name": "a\"b\n", "tags": ["x", 1.5, null, false], "empty": {}, "list": []})"), arena);
+    ASSERT_TRUE(res);
+
+    for (bool pretty : {false, true}) {
+        std::string text;
+        {
+            StringSink sink(text);
+            StreamWriter w(sink, WriterOptions{pretty, 2});
+            w.begin_object()
+                .key("id").value(42)
+                .key("name").value("a\"b\n")
+                .key("tags").begin_array().value("x").value(1.5).value(nullptr).value(false).end_array()
+                .key("empty").begin_object().end_object()
+                .key("list").begin_array().end_array()
+             .end_object();
+            EXPECT_TRUE(w.finish());
+        }
+        EXPECT_EQ(text, write(*res, pretty));
+    }
+
+    // Integers are written exactly, even beyond 2^53
+    std::string big;
+    {
+        StringSink sink(big);
+        StreamWriter w(sink);
+        w.begin_array().value(int64_t{-9007199254740993}).value(uint64_t{18446744073709551615u}).end_array();
+        EXPECT_TRUE(w.finish());
+    }
+    EXPECT_EQ(big, "[-9007199254740993,18446744073709551615]");
+}
+
+TEST_F(JsonTest, StreamWriterRejectsInvalidNesting) {
+    std::string text;
+    StringSink sink(text);
+
+    StreamWriter value_without_key(sink);
+    value_without_key.begin_object().value(1);
+    auto res = value_without_key.finish();
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().code, ErrorCode::UnexpectedToken);
+    EXPECT_EQ(res.error().offset, 1u);
+
+    StreamWriter mismatched(sink);
+    mismatched.begin_array().end_object();
+    EXPECT_TRUE(mismatched.failed());
+
+    StreamWriter unclosed(sink);
+    unclosed.begin_array().value(true);
+    res = unclosed.finish();
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().code, ErrorCode::UnexpectedEOF);
+
+    StreamWriter two_roots(sink);
+    two_roots.value(1).value(2);
+    EXPECT_FALSE(two_roots.finish());
+
+    StreamWriter deep(sink);
+    for (size_t i = 0; i <= StreamWriter::MaxDepth; ++i) deep.begin_array();
+    res = deep.finish();
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().code, ErrorCode::TooDeep);
+}
+
+TEST_F(JsonTest, WriteDeepNestingWithoutRecursion) {
+    auto nest = [&](size_t depth) {
+        Node* node = arena.alloc<Node>();
+        *node = Node::make_number(7);
+        for (size_t i = 0; i < depth; ++i) {
+            Node** slot = arena.alloc<Node*>();
+            *slot = node;
+            node = arena.alloc<Node>();
+            *node = Node::make_array(slot, 1);
+        }
+        return node;
+    };
+
+    // Far deeper than the parser accepts; recursion would exhaust the stack
+    constexpr size_t Depth = 200000;
+    EXPECT_EQ(write(nest(Depth)), std::string(Depth, '[') + "7" + std::string(Depth, ']'));
+
+    // Indentation deeper than the initial indentation buffer
+    Node* deep = nest(3000);
+    Writer pretty(true, 1);
+    std::string text = pretty.write(deep);
+    EXPECT_EQ(text.size(), pretty.measure(deep));
+    EXPECT_EQ(text.substr(0, 8), "[\n [\n  [");
+    EXPECT_EQ(text.substr(text.size() - 5), "\n ]\n]");
+    EXPECT_NE(text.find("\n" + std::string(3000, ' ') + "7\n"), std::string::npos);
+}
+
+TEST_F(JsonTest, ParallelWriteMatchesSequential) {
+    std::string input = R"({"items": [)";
+    for (int i = 0; i < 5000; ++i) {
+        input += R"({"id": )" + std::to_string(i) + R"(, "name": "n\t)" + std::to_string(i) + R"(", "v": [1.5, {}]},)";
+    }
+    input += "null]}";
+    auto res = parse(std::string_view(input), arena);
+    ASSERT_TRUE(res);
+
+    for (bool pretty : {false, true}) {
+        Writer writer(pretty, 2);
+        std::string expected = writer.write(*res);
+
+        auto pieces = writer.write_chunks(*res, ParallelOptions{4, 500});
+        EXPECT_EQ(pieces.size(), 6u);
+        std::string joined;
+        for (const auto& piece : pieces) joined += piece;
+        EXPECT_EQ(joined, expected);
+
+        EXPECT_EQ(writer.write_parallel(*res, ParallelOptions{3, 100}), expected);
+
+        FILE* file = std::tmpfile();
+        ASSERT_NE(file, nullptr);
+        EXPECT_TRUE(write_gather(fileno(file), pieces));
+        std::rewind(file);
+        std::string from_file(expected.size() + 1, '\0');
+        from_file.resize(std::fread(from_file.data(), 1, from_file.size(), file));
+        std::fclose(file);
+        EXPECT_EQ(from_file, expected);
+    }
+
+    // Small containers are written in one piece
+    auto small = parse(std::string_view("[1, 2, 3]"), arena);
+    ASSERT_TRUE(small);
+    Writer writer;
+    auto pieces = writer.write_chunks(*small, ParallelOptions{8, 1024});
+    ASSERT_EQ(pieces.size(), 1u);
+    EXPECT_EQ(pieces[0], "[1,2,3]");
+}
+
+TEST_F(JsonTest, VerbatimStringFlag) {
+    auto res = parse(std::string_view("[\"plain text\", \"esc\\\"aped\", \"raw\ttab\", \"caf\xc3\xa9\"]"), arena);
+    ASSERT_TRUE(res);
+    const ArrayView& items = (*res)->array_val;
+    EXPECT_TRUE(items[0]->has_flag(NodeFlag::Verbatim));
+    EXPECT_FALSE(items[1]->has_flag(NodeFlag::Verbatim));
+    // A raw control character needs escaping even without a backslash
+    EXPECT_FALSE(items[2]->has_flag(NodeFlag::Verbatim));
+    EXPECT_TRUE(items[3]->has_flag(NodeFlag::Verbatim));
+
+    std::string text = write(*res);
+    EXPECT_EQ(text, "[\"plain text\",\"esc\\\"aped\",\"raw\\ttab\",\"caf\xc3\xa9\"]");
+    EXPECT_EQ(measure(*res), text.size());
+
+    // Factory functions start without flags
+    EXPECT_FALSE(make_string(arena, "x")->has_flag(NodeFlag::Verbatim));
+}
+
+TEST_F(JsonTest, CanonicalNumbers) {
+    auto canonical = [](double value) {
+        char buffer[MaxNumberLength];
+        return std::string(buffer, format_canonical_number(value, buffer));
+    };
+    EXPECT_EQ(canonical(0.0), "0");
+    EXPECT_EQ(canonical(-0.0), "0");
+    EXPECT_EQ(canonical(-42), "-42");
+    EXPECT_EQ(canonical(4.5), "4.5");
+    EXPECT_EQ(canonical(0.002), "0.002");
+    EXPECT_EQ(canonical(0.000001), "0.000001");
+    EXPECT_EQ(canonical(1e-7), "1e-7");
+    EXPECT_EQ(canonical(1e20), "100000000000000000000");
+    EXPECT_EQ(canonical(1e21), "1e+21");
+    EXPECT_EQ(canonical(1e30), "1e+30");
+    EXPECT_EQ(canonical(1152921504606846976.0), "1152921504606847000");
+    EXPECT_EQ(canonical(333333333.33333329), "333333333.3333333");
+    EXPECT_EQ(canonical(-1.5e-300), "-1.5e-300");
+    EXPECT_EQ(canonical(5e-324), "5e-324");
+    EXPECT_EQ(canonical(1.7976931348623157e308), "1.7976931348623157e+308");
+}
+
+TEST_F(JsonTest, CanonicalWriter) {
+    // Example from RFC 8785 section 3.2.2
+    auto res = parse(std::string_view(R"({
+        "numbers": [333333333.33333329, 1E30, 4.50, 2e-3, 0.000000000000000000000000001],
+        "string": "\u20ac$\u000F\u000aA'\u0042\u0022\u005c\\\"\/",
+        "literals": [null, true, false]
+    })"), arena);
+    ASSERT_TRUE(res);
+    auto text = write_canonical(*res);
+    ASSERT_TRUE(text);
+    EXPECT_EQ(*text, "{\"literals\":[null,true,false],\"numbers\":[333333333.3333333,1e+30,4.5,0.002,1e-27],"
+                     "\"string\":\"\xe2\x82\xac$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}");
+
+    // Sorting by UTF-16 code units (RFC 8785 section 3.2.3)
+    auto keys = parse(std::string_view(R"({"\u20ac": 1, "\r": 2, "\ufb33": 3, "1": 4, "\ud83d\ude00": 5, "\u0080": 6, "\u00f6": 7, "nested": {"b": [], "a": {}}})"), arena);
+    ASSERT_TRUE(keys);
+    std::string source_order = write(*keys);
+    text = write_canonical(*keys);
+    ASSERT_TRUE(text);
+    EXPECT_EQ(*text, "{\"\\r\":2,\"1\":4,\"nested\":{\"a\":{},\"b\":[]},\"\xc2\x80\":6,\"\xc3\xb6\":7,"
+                     "\"\xe2\x82\xac\":1,\"\xf0\x9f\x98\x80\":5,\"\xef\xac\xb3\":3}");
+    // The tree itself is left in source order
+    EXPECT_EQ(write(*keys), source_order);
+
+    Node* nan = arena.alloc<Node>();
+    *nan = Node::make_number(std::numeric_limits<double>::quiet_NaN());
+    auto rejected = write_canonical(nan);
+    ASSERT_FALSE(rejected);
+    EXPECT_EQ(rejected.error().code, ErrorCode::InvalidNumber);
+}
+
+TEST(DocumentTest, ParseMappedFile) {
+    std::string path = ::testing::TempDir() + "cpp_json_mapped.json";
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs(R"({"name": "mapped", "escaped": "a\nb", "values": [1, 2, 3]})", file);
+        std::fclose(file);
+    }
+
+    auto doc = parse_document_file(path.c_str());
+    ASSERT_TRUE(doc);
+    std::span<const char> source = doc->source();
+    ASSERT_FALSE(source.empty());
+
+    // Escape-free strings point into the mapping instead of the arena
+    const Node* name = (*doc)->object_val.find("name");
+    ASSERT_NE(name, nullptr);
+    EXPECT_GE(name->string_val.data, source.data());
+    EXPECT_LT(name->string_val.data, source.data() + source.size());
+
+    Document moved = std::move(*doc);
+    EXPECT_EQ(write(moved.root()), R"({"name":"mapped","escaped":"a\nb","values":[1,2,3]})");
+    std::remove(path.c_str());
+
+    auto missing = parse_document_file("/nonexistent/cpp_json.json");
+    EXPECT_FALSE(missing);
+}
+
+TEST(DocumentTest, AsyncLoader) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 16; ++i) {
+        paths.push_back(::testing::TempDir() + "cpp_json_async_" + std::to_string(i) + ".json");
+        std::FILE* file = std::fopen(paths.back().c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fprintf(file, "{\"id\": %d, \"items\": [%d, \"x\"]}", i, i * 2);
+        std::fclose(file);
+    }
+
+    std::vector<std::string> seen;
+    std::mutex seen_mutex;
+    {
+        AsyncLoader loader(4);
+        EXPECT_EQ(loader.threads(), 4u);
+
+        std::vector<std::future<Result<Document>>> futures;
+        for (const auto& path : paths) futures.push_back(loader.load(path));
+        for (int i = 0; i < 16; ++i) {
+            auto doc = futures[i].get();
+            ASSERT_TRUE(doc);
+            EXPECT_EQ(write(doc->root()), "{\"id\":" + std::to_string(i) + ",\"items\":[" +
+                                              std::to_string(i * 2) + ",\"x\"]}");
+        }
+
+        for (const auto& path : paths) {
+            loader.load(path, [&](const std::string& loaded, Result<Document> doc) {
+                std::lock_guard lock(seen_mutex);
+                if (doc) seen.push_back(loaded);
+            });
+        }
+        loader.wait();
+        EXPECT_EQ(loader.pending(), 0u);
+
+        auto missing = loader.load("/nonexistent/cpp_json.json").get();
+        EXPECT_FALSE(missing);
+    }
+
+    std::sort(seen.begin(), seen.end());
+    std::vector<std::string> expected = paths;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(seen, expected);
+    for (const auto& path : paths) std::remove(path.c_str());
+}
+
+TEST_F(JsonTest, ParseBatch) {
+    std::vector<std::string> messages;
+    for (int i = 0; i < 200; ++i) {
+        messages.push_back(i % 50 == 7 ? "{\"id\": " + std::to_string(i) + ","
+                                       : "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\\nb\", [" +
+                                             std::to_string(i) + "]]}");
+    }
+    std::vector<std::span<const char>> inputs;
+    for (const auto& message : messages) inputs.emplace_back(message.data(), message.size());
+
+    auto check = [&](const std::vector<Result<Node*>>& results) {
+        ASSERT_EQ(results.size(), messages.size());
+        for (int i = 0; i < 200; ++i) {
+            if (i % 50 == 7) {
+                ASSERT_FALSE(results[i]);
+                EXPECT_EQ(results[i].error().offset, messages[i].size());
+            } else {
+                ASSERT_TRUE(results[i]);
+                EXPECT_EQ(write(*results[i]), "{\"id\":" + std::to_string(i) + ",\"tags\":[\"a\\nb\",[" +
+                                                  std::to_string(i) + "]]}");
+            }
+        }
+    };
+
+    check(parse_batch(inputs, arena));
+
+    // Default thread arena blocks and parser scratch stay out of dedicated chunks
+    ConcurrentArena single;
+    check(parse_batch(inputs, single, 1));
+    EXPECT_EQ(single.chunks(), 1u);
+
+    ConcurrentArena shared;
+    check(parse_batch(inputs, shared, 4, 4096));
+    check(parse_batch(inputs, shared, 1000));
+    EXPECT_TRUE(parse_batch({}, shared).empty());
+}
+
+TEST_F(JsonTest, ValidateMatchesParse) {
+    std::vector<std::string> inputs = {
+        "null", " true ", "-0.5e+3", R"("a\"b\u00e9\ud83d\ude00")", "[]", "{}", "[1, [2, {}], {\"k\": [null]}]",
+        R"({"a": {"b": [1, 2, "x\ny"]}, "c": false})",
+        "", "   ", "[", "[1,]", "[1 2]", "[1}", "{\"a\" 1}", "{\"a\": 1,}", "{1: 2}", "{\"a\": }",
+        "01", "1.", "-", "1e", "1e999", "tru", "nul", "\"abc", R"("\x")", R"("\u12G4")", R"("\ud800x")",
+        "[] []", "{} x", std::string(300, '[') + std::string(300, ']'),
+        std::string(256, '[') + std::string(256, ']'), std::string(257, '{'),
+    };
+
+    for (const auto& input : inputs) {
+        SCOPED_TRACE(input.substr(0, 40));
+        arena.reset();
+        auto parsed = parse(std::string_view(input), arena);
+        auto valid = validate(std::string_view(input));
+        ASSERT_EQ(static_cast<bool>(valid), static_cast<bool>(parsed));
+        if (!parsed) {
+            EXPECT_EQ(valid.error().code, parsed.error().code);
+            EXPECT_EQ(valid.error().offset, parsed.error().offset);
+        }
+    }
+}
+
+TEST_F(JsonTest, ValidateUtf8Option) {
+    ParseOptions strict{.validate_utf8 = true};
+    // Long enough for the vector loops, with multi-byte text in and after them
+    std::string ascii(40, 'a');
+    std::vector<std::string> valid = {
+        "\"" + ascii + "\"", "\"" + ascii + "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"",
+        "\"\xed\x9f\xbf\xee\x80\x80\xf4\x8f\xbf\xbf\"", R"("\ud83d\ude00 \u00e9")",
+    };
+    for (const auto& input : valid) {
+        SCOPED_TRACE(input);
+        auto root = parse(std::string_view(input), arena, strict);
+        ASSERT_TRUE(root);
+        EXPECT_EQ(write(*root), input.find('\\') == std::string::npos ? input : "\"\xf0\x9f\x98\x80 \xc3\xa9\"");
+        EXPECT_TRUE(validate(std::string_view(input), strict));
+    }
+
+    // Ill-formed input: offset of the first bad byte
+    std::vector<std::pair<std::string, size_t>> invalid = {
+        {"\"" + ascii + "\x80\"", 41},                  // Stray continuation byte
+        {"\"\xc0\xaf\"", 1},                            // Overlong
+        {"\"\xe0\x9f\xbf\"", 1},                        // Overlong
+        {"\"\xed\xa0\x80\"", 1},                        // Surrogate
+        {"\"\xf4\x90\x80\x80\"", 1},                    // Above U+10FFFF
+        {"\"\xf5\x80\x80\x80\"", 1},
+        {"\"ab\xe2\x82\"", 3},                          // Truncated
+        {"[\"" + ascii + "\xc3\"]", 42},
+        {"\"tab\there\"", 4},                            // Raw control character
+        {"\"x\\n\ny\"", 4},
+    };
+    for (const auto& [input, offset] : invalid) {
+        SCOPED_TRACE(input);
+        auto root = parse(std::string_view(input), arena, strict);
+        ASSERT_FALSE(root);
+        EXPECT_EQ(root.error().code, ErrorCode::InvalidString);
+        EXPECT_EQ(root.error().offset, offset);
+        auto valid_result = validate(std::string_view(input), strict);
+        ASSERT_FALSE(valid_result);
+        EXPECT_EQ(valid_result.error().offset, offset);
+        // Accepted without the option
+        EXPECT_TRUE(parse(std::string_view(input), arena));
+    }
+
+    auto lone = parse(R"("\udc00")"sv, arena, strict);
+    ASSERT_FALSE(lone);
+    EXPECT_EQ(lone.error().code, ErrorCode::InvalidEscape);
+    EXPECT_TRUE(parse(R"("\udc00")"sv, arena));
+
+    // Escape-free non-ASCII strings stay verbatim
+    auto text = parse("\"caf\xc3\xa9\""sv, arena, strict);
+    ASSERT_TRUE(text);
+    EXPECT_TRUE((*text)->has_flag(NodeFlag::Verbatim));
+}
+
+TEST_F(JsonTest, ParseOptionsLimitsAndPolicies) {
+    // Parser and validator agree on success, error code and offset
+    auto expect_error = [&](std::string_view input, const ParseOptions& options, ErrorCode code, size_t offset) {
+        SCOPED_TRACE(input);
+        auto parsed = parse(input, arena, options);
+        ASSERT_FALSE(parsed);
+        EXPECT_EQ(parsed.error().code, code);
+        EXPECT_EQ(parsed.error().offset, offset);
+        auto valid = validate(input, options);
+        ASSERT_FALSE(valid);
+        EXPECT_EQ(valid.error().code, code);
+        EXPECT_EQ(valid.error().offset, offset);
+        // Accepted by default
+        EXPECT_TRUE(parse(input, arena));
+    };
+
+    ParseOptions depth{.max_depth = 2};
+    EXPECT_TRUE(parse(R"([[1], {"a": 2}])"sv, arena, depth));
+    expect_error(R"([[1], {"a": [2]}])", depth, ErrorCode::TooDeep, 13);
+
+    ParseOptions size{.max_document_size = 8};
+    EXPECT_TRUE(validate("[1, 2]"sv, size));
+    expect_error("[1, 2, 3]", size, ErrorCode::TooLarge, 8);
+
+    ParseOptions strings{.max_string_length = 3};
+    EXPECT_TRUE(parse(R"({"abc": "\u00e9x"})"sv, arena, strings));   // Limit applies after unescaping
+    expect_error(R"({"abc": "abcd"})", strings, ErrorCode::TooLarge, 8);
+    expect_error(R"({"abcd": 1})", strings, ErrorCode::TooLarge, 1);
+    expect_error(R"(["a\nbc"])", strings, ErrorCode::TooLarge, 1);
+
+    ParseOptions integers{.number_mode = NumberMode::Integer};
+    EXPECT_TRUE(parse("[0, -12, 9007199254740992]"sv, arena, integers));
+    expect_error("[1, 2.0]", integers, ErrorCode::InvalidNumber, 4);
+    expect_error("[1e3]", integers, ErrorCode::InvalidNumber, 1);
+    expect_error("[9007199254740993]", integers, ErrorCode::InvalidNumber, 1);
+
+    ParseOptions reject{.duplicate_keys = DuplicateKeys::Reject};
+    EXPECT_TRUE(parse(R"({"a": 1, "b": {"a": 2}})"sv, arena, reject));
+    expect_error(R"({"a": 1, "b": 2, "c": {"x": 1, "x": 2}, "b": 3})", reject, ErrorCode::DuplicateKey, 31);
+    expect_error(R"({"b": 1, "a": 2, "\u0061": 3, "b": 4})", reject, ErrorCode::DuplicateKey, 17);
+
+    ParseOptions last{.duplicate_keys = DuplicateKeys::KeepLast};
+    auto merged = parse(R"({"a": 1, "b": 2, "a": 3, "c": {"d": 4, "d": 5}, "b": 6})"sv, arena, last);
+    ASSERT_TRUE(merged);
+    EXPECT_EQ(write(*merged), R"({"a":3,"c":{"d":5},"b":6})");
+    EXPECT_TRUE(validate(R"({"a": 1, "a": 2})"sv, last));
+}
+
+TEST_F(JsonTest, ParsePolicies) {
+    std::string_view input = R"({"id": 42, "tags": ["a\tb", "caf\u00e9"], "nested": [[-7]]})";
+    std::string expected = R"({"id":42,"tags":["a\tb","café"],"nested":[[-7]]})";
+    for (auto root : {parse<DefaultPolicy>(input, arena), parse<TrustedPolicy>(input, arena),
+                      parse<StrictPolicy>(input, arena), parse<TrustedIntegerPolicy>(input, arena)}) {
+        ASSERT_TRUE(root);
+        EXPECT_EQ(write(*root), expected);
+    }
+
+    // Fixed policies compile in their own checks and ignore runtime options
+    ParseOptions shallow{.max_depth = 1};
+    EXPECT_FALSE(parse<DefaultPolicy>(input, arena, shallow));
+    EXPECT_TRUE(parse<TrustedPolicy>(input, arena, shallow));
+
+    std::string_view raw = "[\"bad \xff byte\"]";
+    EXPECT_TRUE(parse<TrustedPolicy>(raw, arena));
+    auto strict = parse<StrictPolicy>(raw, arena);
+    ASSERT_FALSE(strict);
+    EXPECT_EQ(strict.error().code, ErrorCode::InvalidString);
+    EXPECT_EQ(strict.error().offset, 6u);
+
+    auto fraction = parse<TrustedIntegerPolicy>("[1, 2.5]"sv, arena);
+    ASSERT_FALSE(fraction);
+    EXPECT_EQ(fraction.error().code, ErrorCode::InvalidNumber);
+    EXPECT_EQ(fraction.error().offset, 4u);
+    auto large = parse<TrustedIntegerPolicy>("[-9007199254740992, 9007199254740993]"sv, arena);
+    ASSERT_FALSE(large);
+    EXPECT_EQ(large.error().offset, 20u);
+}
+
+TEST_F(JsonTest, BufferedTokens) {
+    // Enough tokens to span several blocks, with decoded strings in each
+    std::string input = "[";
+    for (int i = 0; i < 1500; ++i) {
+        std::string n = std::to_string(i);
+        input += (i ? ",{\"k\\u00e9" : "{\"k\\u00e9") + n + "\": [" + n + ", \"v" + n + "\", true, null]}";
+    }
+    input += "]";
+
+    ParseOptions buffered{.buffer_tokens = true};
+    auto plain = parse(std::string_view(input), arena);
+    auto blocked = parse(std::string_view(input), arena, buffered);
+    ASSERT_TRUE(plain);
+    ASSERT_TRUE(blocked);
+    EXPECT_EQ(write(*blocked), write(*plain));
+    auto trusted = parse<TrustedPolicy>(std::string_view(input), arena, buffered);
+    ASSERT_TRUE(trusted);
+    EXPECT_EQ(write(*trusted), write(*plain));
+
+    // A failed fill keeps the tokens before the error and ends with a marker
+    std::string_view broken = "[1, tru]";
+    Tokenizer tokenizer(broken, arena);
+    TokenBlock block;
+    tokenizer.fill(block);
+    ASSERT_TRUE(block.failed);
+    ASSERT_EQ(block.size, 4u);
+    EXPECT_EQ(block.tokens[2].type, TokenType::Comma);
+    EXPECT_EQ(block.tokens[3].type, TokenType::Invalid);
+    EXPECT_EQ(block.tokens[3].offset, block.error.offset);
+
+    // The block comes from the arena's upstream, like the other parser scratch
+    CountingResource upstream;
+    size_t unbuffered = 0;
+    for (bool buffer : {false, true}) {
+        size_t before = upstream.allocations;
+        Arena local(4096, &upstream);
+        ASSERT_TRUE(parse(R"([1, [2, 3], {"a": true}])"sv, local, {.buffer_tokens = buffer}));
+        if (!buffer) unbuffered = upstream.allocations - before;
+        else EXPECT_EQ(upstream.allocations - before, unbuffered + 1);
+    }
+    EXPECT_EQ(upstream.outstanding, 0u);
+
+    // Errors, including ones several blocks in, match the unbuffered parser
+    std::string late = input.substr(0, input.size() - 1) + ", tru]";
+    std::string deep(300, '[');
+    for (std::string_view bad : {std::string_view(late), std::string_view(deep), "[1, }"sv,
+                                 "{\"a\" 1}"sv, "\"\\x\""sv, "[1] 2"sv, ""sv}) {
+        auto expected = parse(bad, arena);
+        auto actual = parse(bad, arena, buffered);
+        ASSERT_FALSE(expected);
+        ASSERT_FALSE(actual);
+        EXPECT_EQ(actual.error().code, expected.error().code);
+        EXPECT_EQ(actual.error().offset, expected.error().offset);
+    }
+}
+
+TEST_F(JsonTest, StreamParserAnyChunking) {
+    std::string input = R"( {"name": "café 😀", "esc": "a\"b\\c\/\n", "num": [-0.5e+3, 0, 123456, 1E2],
+                            "lit": [true, false, null], "nested": {"empty": {}, "list": [[]]}} )";
+    auto expected = parse(std::string_view(input), arena);
+    ASSERT_TRUE(expected);
+    std::string text = write(*expected);
+
+    // Every split point, so each token is cut at each of its bytes once
+    for (size_t split = 0; split <= input.size(); ++split) {
+        Arena local;
+        DomBuilder builder(local);
+        StreamParser parser(builder);
+        ASSERT_TRUE(parser.feed(std::string_view(input).substr(0, split))) << split;
+        ASSERT_TRUE(parser.feed(std::string_view(input).substr(split))) << split;
+        ASSERT_TRUE(parser.finish()) << split;
+        EXPECT_EQ(write(builder.root()), text) << split;
+    }
+
+    // One byte at a time through the stream driver
+    std::istringstream in(input);
+    auto root = parse_stream(in, arena, 1);
+    ASSERT_TRUE(root);
+    EXPECT_EQ(write(*root), text);
+
+    // A top-level number is completed by finish()
+    std::istringstream number("-12.5e1");
+    root = parse_stream(number, arena, 2);
+    ASSERT_TRUE(root);
+    EXPECT_EQ((*root)->number_val, -125.0);
+}
+
+TEST_F(JsonTest, ParseAsyncSuspendsForInput) {
+    ChunkChannel channel;
+    Task<Result<Node*>> task = parse_async(channel, arena);
+    task.start();
+    EXPECT_FALSE(task.done());
+    EXPECT_TRUE(channel.waiting());
+
+    // Each chunk resumes the parser, which suspends again once it is consumed
+    for (std::string_view chunk : {R"({"na)"sv, R"(me": "as)"sv, R"(ync", "list": [1, 2)"sv, "]}"sv}) {
+        channel.push(chunk);
+        EXPECT_FALSE(task.done());
+    }
+    channel.close();
+    ASSERT_TRUE(task.done());
+    auto root = std::move(task).get();
+    ASSERT_TRUE(root);
+    EXPECT_EQ(write(*root), R"({"name":"async","list":[1,2]})");
+
+    // Awaiting from another coroutine, with queued input and an error
+    ChunkChannel broken;
+    broken.push("[1, ");
+    broken.push("}");
+    broken.close();
+    auto outer = [](ChunkChannel& source, Arena& nodes) -> Task<Result<Node*>> {
+        co_return co_await parse_async(source, nodes);
+    };
+    Task<Result<Node*>> failing = outer(broken, arena);
+    failing.start();
+    ASSERT_TRUE(failing.done());
+    EXPECT_FALSE(failing.get());
+    EXPECT_EQ(failing.get().error().code, ErrorCode::ExpectedValue);
+}
+
+TEST_F(JsonTest, StreamParserEventsAndErrors) {
+    struct Counter : EventHandler {
+        size_t values = 0, documents = 0, max_depth = 0, depth = 0;
+        bool on_null() override { ++values; return true; }
+        bool on_number(double) override { ++values; return true; }
+        bool on_string(std::string_view) override { ++values; return true; }
+        bool on_begin_object() override { max_depth = std::max(max_depth, ++depth); return true; }
+        bool on_end_object() override { --depth; ++values; return true; }
+        bool on_document_end() override { ++documents; return true; }
+    };
+
+    // NDJSON: one document per line
+    Counter ndjson;
+    std::istringstream lines("{\"a\": 1}\n{\"b\": {\"c\": \"x\"}}\n7\nnull\n");
+    ASSERT_TRUE(parse_stream(lines, ndjson, true, 5));
+    EXPECT_EQ(ndjson.documents, 4u);
+    EXPECT_EQ(ndjson.values, 7u);
+    EXPECT_EQ(ndjson.max_depth, 2u);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    std::fputs("[1, 2] [3]", file);
+    std::fflush(file);
+    std::rewind(file);
+    Counter single;
+    auto res = parse_stream(fileno(file), single, false, 4);
+    std::fclose(file);
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().code, ErrorCode::UnexpectedToken);
+    EXPECT_EQ(res.error().offset, 7u);
+
+    auto error_of = [](std::string_view input) {
+        EventHandler ignore;
+        StreamParser parser(ignore);
+        auto ok = parser.feed(input);
+        if (ok) ok = parser.finish();
+        return ok ? ErrorCode::None : ok.error().code;
+    };
+    EXPECT_EQ(error_of(R"({"a" 1})"), ErrorCode::ExpectedColon);
+    EXPECT_EQ(error_of("[1 2]"), ErrorCode::ExpectedComma);
+    EXPECT_EQ(error_of("[1,]"), ErrorCode::ExpectedValue);
+    EXPECT_EQ(error_of("[1}"), ErrorCode::UnexpectedToken);
+    EXPECT_EQ(error_of("[01]"), ErrorCode::InvalidNumber);
+    EXPECT_EQ(error_of("[tru]"), ErrorCode::InvalidToken);
+    EXPECT_EQ(error_of(R"(["\x"])"), ErrorCode::InvalidEscape);
+    EXPECT_EQ(error_of(R"(["\ud83d"])"), ErrorCode::InvalidEscape);
+    EXPECT_EQ(error_of(R"({"open": [)"), ErrorCode::UnexpectedEOF);
+    EXPECT_EQ(error_of(""), ErrorCode::UnexpectedEOF);
+    EXPECT_EQ(error_of(std::string(StreamParser::MaxDepth + 1, '[')), ErrorCode::TooDeep);
+
+    struct Stop : EventHandler {
+        bool on_number(double) override { return false; }
+    } stop;
+    StreamParser stopped(stop);
+    auto cancelled = stopped.feed(std::string_view("[1, 2]"));
+    ASSERT_FALSE(cancelled);
+    EXPECT_EQ(cancelled.error().code, ErrorCode::Cancelled);
+    EXPECT_EQ(cancelled.error().offset, 1u);
+}
@@ -1,9 +1,13 @@
 #include "json/api.hpp"
+#include "json/stream_parser.hpp"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <iterator>
 #include <cstring>
 #include <format>
+#include <optional>
+#include <string>
 
 void print_usage(const char* prog) {
     std::cerr << std::format("Usage: {} <command> [options] <file>\n", prog);
@@ -14,51 +18,35 @@ void print_usage(const char* prog) {
     std::cerr << "  stats      Show JSON statistics\n";
 }
 
-std::string read_input(const std::string& path) {
-    if (path == "-") {
-        std::stringstream ss;
-        ss << std::cin.rdbuf();
-        return ss.str();
-    }
-    std::ifstream f(path, std::ios::binary);
-    if (!f) throw std::runtime_error("Cannot open file");
-    std::stringstream ss;
-    ss << f.rdbuf();
-    return ss.str();
-}
+// Counts values while parsing, so statistics need no tree in memory
+struct StatsHandler : json::EventHandler {
+    size_t obj = 0, arr = 0, str = 0, num = 0, bool_val = 0, null_val = 0;
+    size_t depth = 0, max_depth = 0;
 
-void print_stats(const json::Node* node) {
-    // Simple recursive stats counter
-    struct Stats { size_t obj=0, arr=0, str=0, num=0, bool_val=0, null_val=0, depth=0; } stats;
-    auto traverse = [&](auto&& self, const json::Node* n, size_t d) -> void {
-        if (!n) return;
-        if (d > stats.depth) stats.depth = d;
-        if (n->is_object()) {
-            stats.obj++;
-            if (auto obj = n->as_object()) {
-                for (auto it = obj->begin(); it != obj->end(); ++it) self(self, it->value, d + 1);
-            }
-        } else if (n->is_array()) {
-            stats.arr++;
-            if (auto arr = n->as_array()) {
-                for (auto* child : *arr) self(self, child, d + 1);
-            }
-        } else if (n->is_string()) stats.str++;
-        else if (n->is_number()) stats.num++;
-        else if (n->is_bool()) stats.bool_val++;
-        else if (n->is_null()) stats.null_val++;
-    };
-    
-    traverse(traverse, node, 0);
-    
+    void value() { max_depth = std::max(max_depth, depth); }
+    bool on_null() override { value(); null_val++; return true; }
+    bool on_bool(bool) override { value(); bool_val++; return true; }
+    bool on_number(double) override { value(); num++; return true; }
+    bool on_string(std::string_view) override { value(); str++; return true; }
+    bool on_begin_object() override { value(); obj++; depth++; return true; }
+    bool on_end_object() override { depth--; return true; }
+    bool on_begin_array() override { value(); arr++; depth++; return true; }
+    bool on_end_array() override { depth--; return true; }
+};
+
+void print_stats(const StatsHandler& stats) {
     std::cout << "JSON Statistics:\n"
-              << "  Max Depth: " << stats.depth << "\n"
+              << "  Max Depth: " << stats.max_depth << "\n"
               << "  Objects:   " << stats.obj << "\n"
               << "  Arrays:    " << stats.arr << "\n"
               << "  Strings:   " << stats.str << "\n"
               << "  Numbers:   " << stats.num << "\n";
 }
 
+void print_error(const json::Error& error) {
+    std::cerr << std::format("Error: {} (offset: {})\n", error.message, error.offset);
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 3) {
         print_usage(argv[0]);
@@ -69,24 +57,70 @@ int main(int argc, char* argv[]) {
     std::string file_path = argv[2];
 
     try {
-        json::Arena arena;
-        std::string content = read_input(file_path);
-        
-        auto result = json::parse(std::span(content.data(), content.size()), arena);
-        if (!result) {
-            std::cerr << std::format("Error: {} (offset: {})\n", 
-                result.error().message, result.error().offset);
-            return 1;
-        }
-
         if (command == "validate") {
+            // One engine for files and stdin, so both report the same errors.
+            // Files are checked in place from a mapping: no tree and no copy
+            json::Result<void> result;
+            if (file_path == "-") {
+                std::string input{std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()};
+                result = json::validate(std::string_view(input));
+            } else {
+                auto file = json::MappedFile::open(file_path.c_str());
+                if (!file) throw std::runtime_error("Cannot open file");
+                result = json::validate(file->data());
+            }
+            if (!result) {
+                print_error(result.error());
+                return 1;
+            }
             std::cout << "Valid JSON.\n";
-        } else if (command == "format") {
-            std::cout << json::write(*result, true) << "\n";
-        } else if (command == "minify") {
-            std::cout << json::write(*result, false) << "\n";
         } else if (command == "stats") {
-            print_stats(*result);
+            // Stream in fixed-size chunks: memory use does not grow with the input
+            StatsHandler stats;
+            json::Result<void> result;
+            if (file_path == "-") {
+                result = json::parse_stream(std::cin, stats);
+            } else {
+                std::ifstream file(file_path, std::ios::binary);
+                if (!file) throw std::runtime_error("Cannot open file");
+                result = json::parse_stream(file, stats);
+            }
+            if (!result) {
+                print_error(result.error());
+                return 1;
+            }
+            print_stats(stats);
+        } else if (command == "format" || command == "minify") {
+            // Files are parsed from a memory mapping, stdin in chunks
+            json::Arena arena;
+            std::optional<json::Document> document;
+            const json::Node* root = nullptr;
+            if (file_path == "-") {
+                auto result = json::parse_stream(std::cin, arena);
+                if (!result) {
+                    print_error(result.error());
+                    return 1;
+                }
+                root = *result;
+            } else {
+                auto result = json::parse_document_file(file_path.c_str());
+                if (!result) {
+                    print_error(result.error());
+                    return 1;
+                }
+                document.emplace(std::move(*result));
+                root = document->root();
+            }
+
+            // Stream through a fixed buffer instead of building the whole text
+            std::cout.flush();
+            json::FileSink out(stdout);
+            json::write(root, out, command == "format");
+            out.put('\n');
+            if (!out.flush()) {
+                std::cerr << "Error: failed to write output\n";
+                return 1;
+            }
         } else {
             std::cerr << "Unknown command: " << command << "\n";
             return 1;